@@ -0,0 +1,80 @@
+/**
+* \file ActivationBenchmark.cpp
+*
+* \brief Benchmark of the approximate accuracy policies of the Sigmoid, Tanh and Softmax layers against their exact
+*        activation functions
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <neural/Neural.hpp>
+
+/**
+ * @brief Time a function, repeating it until enough time has passed for a stable measurement
+ * @tparam Function The type of the function
+ * @param function The function to time
+ * @return The average time of a call, in seconds
+ */
+template <typename Function>
+double timeIt(Function &&function) {
+    using Clock = std::chrono::steady_clock;
+    function();
+    unsigned long repetitions = 1;
+    while (true) {
+        const auto start = Clock::now();
+        for (unsigned long i = 0; i < repetitions; i++) {
+            function();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds > 0.2) {
+            return seconds / repetitions;
+        }
+        repetitions *= 2;
+    }
+}
+
+/**
+ * @brief Benchmark the inference pass of an activation layer with every accuracy policy
+ * @tparam Layer The activation layer template
+ * @tparam Scalar The scalar type
+ * @tparam BatchSize The batch size of the layer
+ * @tparam Size The number of inputs to the layer
+ */
+template <template <typename, int, int, typename> class Layer, typename Scalar, int BatchSize, int Size>
+void benchmark(const char *layerName, const char *scalarName) {
+    neural::Tensor<Scalar, BatchSize, Size> x;
+    x.setRandom();
+    neural::Tensor<Scalar, BatchSize, Size> y;
+    const Layer<Scalar, Size, BatchSize, neural::accuracy::Exact> exact;
+    const Layer<Scalar, Size, BatchSize, neural::accuracy::High> high;
+    const Layer<Scalar, Size, BatchSize, neural::accuracy::Low> low;
+
+    const double exactSeconds = timeIt([&]() { y = exact.predict(x); });
+    const double highSeconds = timeIt([&]() { y = high.predict(x); });
+    const double lowSeconds = timeIt([&]() { y = low.predict(x); });
+    std::printf("%-8s %-6s %4d x %4d   Exact: %8.3f us   High: %8.3f us (%.2fx)   Low: %8.3f us (%.2fx)\n",
+                layerName, scalarName, BatchSize, Size, exactSeconds * 1e6, highSeconds * 1e6, exactSeconds / highSeconds,
+                lowSeconds * 1e6, exactSeconds / lowSeconds);
+}
+
+int main() {
+    std::printf("Approximations instruction set: %s\n", neural::isaName(neural::cpuIsa()));
+
+    // Narrow layers of single sample inference, followed by the batches of training and evaluation
+    benchmark<neural::Tanh, float, 1, 64>("Tanh", "float");
+    benchmark<neural::Tanh, float, 64, 256>("Tanh", "float");
+    benchmark<neural::Tanh, double, 1, 64>("Tanh", "double");
+    benchmark<neural::Tanh, double, 64, 256>("Tanh", "double");
+    benchmark<neural::Sigmoid, float, 1, 64>("Sigmoid", "float");
+    benchmark<neural::Sigmoid, float, 64, 256>("Sigmoid", "float");
+    benchmark<neural::Sigmoid, double, 1, 64>("Sigmoid", "double");
+    benchmark<neural::Sigmoid, double, 64, 256>("Sigmoid", "double");
+    benchmark<neural::Softmax, float, 1, 10>("Softmax", "float");
+    benchmark<neural::Softmax, float, 100, 10>("Softmax", "float");
+    benchmark<neural::Softmax, double, 1, 10>("Softmax", "double");
+    benchmark<neural::Softmax, double, 100, 10>("Softmax", "double");
+    return 0;
+}
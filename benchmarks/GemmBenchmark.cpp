@@ -0,0 +1,98 @@
+/**
+* \file GemmBenchmark.cpp
+*
+* \brief Benchmark of the matrix products computed by Linear layers of various sizes against Eigen's matrix product,
+*        using the kernels Linear dispatches to (gemv for a batch size of 1, and the microkernels or Eigen otherwise)
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <Eigen/Core>
+#include <neural/util/Gemm.hpp>
+
+/**
+ * @brief Time a function, repeating it until enough time has passed for a stable measurement
+ * @tparam Function The type of the function
+ * @param function The function to time
+ * @return The average time of a call, in seconds
+ */
+template <typename Function>
+double timeIt(Function &&function) {
+    using Clock = std::chrono::steady_clock;
+    function();
+    unsigned long repetitions = 1;
+    while (true) {
+        const auto start = Clock::now();
+        for (unsigned long i = 0; i < repetitions; i++) {
+            function();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds > 0.2) {
+            return seconds / repetitions;
+        }
+        repetitions *= 2;
+    }
+}
+
+/**
+ * @brief Benchmark the output product of a Linear layer, Y = XW, where X is BatchSize x InputSize, with the weights
+ *        as they are used by a trainable layer (neural::matrixProduct) and by a frozen one (neural::matrixProductPacked)
+ * @tparam Scalar The scalar type
+ * @tparam BatchSize The batch size of the layer
+ * @tparam InputSize The number of inputs to the layer
+ * @tparam NumNeurons The number of neurons of the layer
+ */
+template <typename Scalar, unsigned int BatchSize, unsigned int InputSize, unsigned int NumNeurons>
+void benchmark(const char *scalarName) {
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    std::mt19937 generator;
+    std::normal_distribution<Scalar> distribution;
+    std::vector<Scalar> x(BatchSize * InputSize), w(InputSize * NumNeurons), packed(InputSize * NumNeurons);
+    std::vector<Scalar> y(BatchSize * NumNeurons), yPacked(BatchSize * NumNeurons), yEigen(BatchSize * NumNeurons);
+    for (auto &value : x) { value = distribution(generator); }
+    for (auto &value : w) { value = distribution(generator); }
+
+    const Eigen::Map<const Matrix> xMapped(x.data(), BatchSize, InputSize);
+    const Eigen::Map<const Matrix> wMapped(w.data(), InputSize, NumNeurons);
+    Eigen::Map<Matrix> yMapped(yEigen.data(), BatchSize, NumNeurons);
+
+    const double eigenSeconds = timeIt([&]() { yMapped.noalias() = xMapped * wMapped; });
+    const double productSeconds = timeIt([&]() { neural::matrixProduct<BatchSize, InputSize, NumNeurons>(x.data(), w.data(), y.data()); });
+    neural::packRhs<BatchSize, InputSize, NumNeurons>(w.data(), packed.data());
+    const double packedSeconds = timeIt([&]() { neural::matrixProductPacked<BatchSize, InputSize, NumNeurons>(x.data(), packed.data(), yPacked.data()); });
+
+    // Sanity check the results
+    Scalar maxError = 0;
+    for (unsigned int i = 0; i < BatchSize * NumNeurons; i++) {
+        maxError = std::max(maxError, std::max(std::abs(y[i] - yEigen[i]), std::abs(yPacked[i] - yEigen[i])));
+    }
+
+    const double flops = 2.0 * BatchSize * InputSize * NumNeurons;
+    std::printf("%-6s %5u x %5u -> %5u   Eigen: %7.2f GFLOP/s   matrixProduct: %7.2f GFLOP/s (%.2fx)   "
+                "matrixProductPacked: %7.2f GFLOP/s (%.2fx)   max error %.1e\n",
+                scalarName, BatchSize, InputSize, NumNeurons, flops / eigenSeconds * 1e-9,
+                flops / productSeconds * 1e-9, eigenSeconds / productSeconds,
+                flops / packedSeconds * 1e-9, eigenSeconds / packedSeconds, double(maxError));
+}
+
+int main() {
+    std::printf("Matrix product instruction set: %s\n", neural::isaName(neural::cpuIsa()));
+
+    // The MNIST example, followed by larger hidden layers
+    benchmark<double, 100, 784, 10>("double");
+    benchmark<double, 1, 784, 10>("double");
+    benchmark<double, 64, 784, 128>("double");
+    benchmark<double, 64, 256, 256>("double");
+    benchmark<double, 128, 512, 512>("double");
+    benchmark<double, 256, 1024, 1024>("double");
+    benchmark<float, 100, 784, 10>("float");
+    benchmark<float, 64, 784, 128>("float");
+    benchmark<float, 128, 512, 512>("float");
+    benchmark<float, 256, 1024, 1024>("float");
+    return 0;
+}
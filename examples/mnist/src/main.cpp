@@ -8,6 +8,8 @@
 * \author Mathias Bøgh Stokholm
 */
 
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <mnist/mnist_reader.hpp>
 #include <neural/Neural.hpp>
@@ -21,6 +23,15 @@ constexpr unsigned int epochs = 15;
 using InputTensor = neural::Tensor<neural::Derivative, batchSize, inputSize>;
 using OutputTensor = neural::Tensor<neural::Derivative, batchSize, outputSize>;
 
+// Data types used for testing, which doesn't need gradients
+using TestInputTensor = neural::Tensor<double, batchSize, inputSize>;
+
+// The class index of every image in a batch, used for both training and testing
+using Labels = std::array<int, batchSize>;
+
+// Accuracy, top-5 accuracy, mean loss and confusion matrix, accumulated batch by batch without allocations
+using Metrics = neural::Metrics<outputSize>;
+
 /**
  * @brief Normalize the values in a dataset to be in the [0, 1] range
  * @param data [in/out]: The dataset to normalize
@@ -43,6 +54,67 @@ void normalize(std::vector<std::vector<double>> &data) {
     }
 }
 
+/**
+ * @brief Load a batch of images into a tensor, and their labels as class indices
+ * @tparam Input The type of the input tensor
+ * @param images The images to load from
+ * @param labels The labels to load from
+ * @param startIndex The index of the first image in the batch
+ * @return The input tensor and the labels
+ */
+template <typename Input>
+std::tuple<Input, Labels> loadBatch(const std::vector<std::vector<double>> &images, const std::vector<std::uint8_t> &labels,
+                                    unsigned int startIndex) {
+    using Dtype = typename Input::Dtype;
+    Input x;
+    Labels y;
+    for (unsigned int j = 0; j < batchSize; j++) {
+        // Map image at index into input tensor and convert to the scalar type of the tensor
+        const auto index = startIndex + j;
+        auto xMapped = neural::TensorSliceToVector<inputSize, batchSize>(x, j);
+        const auto inputMapped = Eigen::Map<const Eigen::Matrix<double, inputSize, 1>>(images[index].data());
+        xMapped = inputMapped.cast<Dtype>();
+
+        // Store the label at index as a class index, without building a one-hot tensor
+        y[j] = labels.at(index);
+    }
+    return std::make_tuple(std::move(x), std::move(y));
+}
+
+/**
+ * @brief Measure the metrics and inference throughput of a network on a test set
+ * @tparam Network The type of the network
+ * @tparam Loss The type of the loss function used for measuring the loss
+ * @param network The network to evaluate
+ * @param testError The loss function used for measuring the loss
+ * @param images The test images
+ * @param labels The test labels
+ * @return The metrics of the test set, and the number of samples predicted per second
+ */
+template <typename Network, typename Loss>
+std::tuple<Metrics, double> evaluate(const Network &network, const Loss &testError, const std::vector<std::vector<double>> &images,
+                                     const std::vector<std::uint8_t> &labels) {
+    const auto testSteps = images.size() / batchSize;
+    Metrics metrics;
+    std::chrono::duration<double> elapsed(0);
+    for (unsigned int i = 0; i < testSteps; i++) {
+        // Get input/output tensors
+        TestInputTensor x;
+        Labels y;
+        std::tie(x, y) = loadBatch<TestInputTensor>(images, labels, i * batchSize);
+
+        // Perform forward on plain values - no gradients are needed for testing
+        const auto start = std::chrono::steady_clock::now();
+        const auto prediction = network.predict(x);
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        // Determine error
+        metrics.update(prediction, y);
+        metrics.addLoss(testError.compute(prediction, y), batchSize);
+    }
+    return std::make_tuple(metrics, testSteps * batchSize / elapsed.count());
+}
+
 int main(int argc, char* argv[]) {
     // MNIST_DATA_LOCATION set by MNIST cmake config
     std::cout << "MNIST data directory: " << MNIST_DATA_LOCATION << std::endl;
@@ -52,27 +124,6 @@ int main(int argc, char* argv[]) {
     normalize(dataset.training_images);
     normalize(dataset.test_images);
 
-    // Create easy getter function for data
-    auto loadData = [&dataset] (bool training, unsigned int startIndex) {
-        InputTensor x;
-        OutputTensor y;
-        for (unsigned int j = 0; j < batchSize; j++) {
-            // Map image at index into input tensor and convert to neural::Derivative
-            const auto index = startIndex + j;
-            const auto &images = training? dataset.training_images: dataset.test_images;
-            auto xMapped = neural::TensorSliceToVector<inputSize, batchSize>(x, j);
-            const auto inputMapped = Eigen::Map<const Eigen::Matrix<double, inputSize, 1>>(images[index].data());
-            xMapped = inputMapped.cast<neural::Derivative>();
-
-            // Map label at index into output tensor using one-hot encoding
-            const auto &labels = training? dataset.training_labels: dataset.test_labels;
-            auto yMapped = neural::TensorSliceToVector<outputSize, batchSize>(y, j);
-            yMapped = Eigen::Matrix<neural::Derivative, outputSize, 1>::Zero();
-            yMapped[labels.at(index)] = 1;
-        }
-        return std::make_tuple(std::move(x), std::move(y));
-    };
-
     // Create RNG engine and shuffling indexes
     auto rng = std::default_random_engine {};
     std::vector<unsigned int> indexes(dataset.training_images.size());
@@ -85,59 +136,63 @@ int main(int argc, char* argv[]) {
     );
     net.attachOptimizer(neural::OptimizerFactory::Adam(0.1));
 
-    // Create loss function
-    neural::CrossEntropy<neural::Derivative, OutputTensor::ChannelSize, batchSize> error;
+    // Create loss function, and a plain value version of it for measuring test loss
+    neural::SparseCrossEntropy<neural::Derivative, OutputTensor::ChannelSize, batchSize> error;
+    neural::SparseCrossEntropy<double, OutputTensor::ChannelSize, batchSize> testError;
 
 
     //// Training section below
     const auto trainSteps = dataset.training_images.size() / batchSize;
-    const auto testSteps = dataset.test_images.size() / batchSize;
     for (unsigned int epoch = 0; epoch < epochs; epoch++) {
         std::cout << "Epoch: " << epoch << ". Performing test..." << std::endl;
 
         // Step over all test data
-        std::vector<double> accuracies = {};
-        for (unsigned int i = 0; i < testSteps; i++) {
-            neural::GradientGuard guard;
-
-            // Get input/output tensors
-            InputTensor x;
-            OutputTensor y;
-            std::tie(x, y) = loadData(false, i * batchSize);
-
-            // Perform forward
-            const auto prediction = net.forward(x);
-
-            // Determine error
-            accuracies.emplace_back(error.accuracy(prediction, y).val());
-        }
-        const auto accuracy = std::accumulate(accuracies.begin(), accuracies.end(), 0.0) / accuracies.size();
-        std::cout << "Mean test accuracy: " << accuracy << std::endl;
+        const auto metrics = std::get<0>(evaluate(net, testError, dataset.test_images, dataset.test_labels));
+        std::cout << "Mean test accuracy: " << metrics.accuracy() << ". Top-5 accuracy: " << metrics.topKAccuracy()
+                  << ". Mean test loss: " << metrics.meanLoss() << std::endl;
 
         // Shuffle indexes
         std::shuffle(indexes.begin(), indexes.end(), rng);
 
         // Step over all training data
-        std::vector<double> losses = {};
+        Metrics trainMetrics;
         for (unsigned int i = 0; i < trainSteps; i++) {
-            neural::GradientGuard guard;
+            // Record the step in the arena of the net, which is reused across steps
+            neural::GradientGuard guard(net.arena());
 
             // Get input/output tensors
             InputTensor x;
-            OutputTensor y;
-            std::tie(x, y) = loadData(true, i * batchSize);
+            Labels y;
+            std::tie(x, y) = loadBatch<InputTensor>(dataset.training_images, dataset.training_labels, i * batchSize);
 
             // Perform forward
             const auto prediction = net.forward(x);
 
             // Determine error
             auto loss = error.compute(prediction, y);
-            losses.emplace_back(loss.val());
+            trainMetrics.addLoss(loss.val(), batchSize);
 
             // Update weights
             net.backward(loss);
         }
-        const auto meanLoss = std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size();
-        std::cout << "Mean train loss: " << meanLoss << std::endl;
+        std::cout << "Mean train loss: " << trainMetrics.meanLoss() << std::endl;
+        std::cout << "Tape arena: " << net.arena().peakBytes() << " bytes at peak, " << net.arena().nodesUsed()
+                  << " nodes per step, grown " << net.arena().numGrowths() << " times" << std::endl;
     }
+
+
+    //// Quantization section below
+    // Convert the trained linear layer to int8 weights for serving, and compare it to the trained network
+    auto quantizedNet = neural::make_net(
+            neural::quantize(net.layer<0>()),
+            neural::Softmax<double, OutputTensor::ChannelSize, batchSize>()
+    );
+    Metrics metrics, quantizedMetrics;
+    double throughput, quantizedThroughput;
+    std::tie(metrics, throughput) = evaluate(net, testError, dataset.test_images, dataset.test_labels);
+    std::tie(quantizedMetrics, quantizedThroughput) = evaluate(quantizedNet, testError, dataset.test_images, dataset.test_labels);
+    std::cout << "double weights: " << inputSize * outputSize * sizeof(double) << " bytes. Accuracy: "
+              << metrics.accuracy() << ". Throughput: " << throughput << " samples/s" << std::endl;
+    std::cout << "int8 weights: " << quantizedNet.layer<0>().weightsBytes() << " bytes. Accuracy: "
+              << quantizedMetrics.accuracy() << ". Throughput: " << quantizedThroughput << " samples/s" << std::endl;
 }
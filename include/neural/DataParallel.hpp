@@ -0,0 +1,202 @@
+/**
+* \file DataParallel.hpp
+*
+* \brief Class for training a Net on several threads, using one replica of the Net per thread
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_DATAPARALLEL_HPP
+#define NEURAL_DATAPARALLEL_HPP
+
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <neural/util/Gradient.hpp>
+
+namespace neural {
+    /**
+     * @brief Class for training a Net on several threads, using one replica of the Net per thread
+     * Every step, the weights of the Net are copied to all replicas, which then run forward() and computeGradients()
+     * concurrently on their own share of the data, each using its own activations and gradient buffers. The first
+     * replica runs on the calling thread, and every other replica on a worker thread that is started once by the
+     * constructor and waits for the next step in between, so steps don't pay for creating threads. The gradients
+     * of the replicas are merged into the Net in replica order, so the result does not depend on thread scheduling, and
+     * are then applied once using the optimizers of the Net. Every replica's step counts towards the gradient
+     * accumulation of the Net (see Net::setGradientAccumulation()), so the weights are only updated once enough steps
+     * have been merged.
+     * Only native (float/double) Nets are supported: Stan Math keeps a single, process-global auto diff tape, which
+     * cannot be recorded by several threads at once.
+     * @tparam NetType The type of the Net to train
+     * @tparam NumReplicas The number of replicas, i.e. the number of threads to train on
+     */
+    template<typename NetType, unsigned int NumReplicas>
+    class DataParallel {
+        static_assert(IsNative<typename NetType::Dtype>::value, "DataParallel requires a native (float/double) Net");
+        static_assert(NumReplicas > 0, "DataParallel requires at least one replica");
+
+    public:
+        /**
+         * @brief Create a new DataParallel trainer for a Net
+         * @param net The Net to train, which must have an optimizer attached. It must outlive this trainer
+         */
+        explicit DataParallel(NetType &net): m_net(net) {
+            for (auto &replica : m_replicas) {
+                replica.enableGradients();
+            }
+            for (unsigned int i = 1; i < NumReplicas; i++) {
+                m_workers[i - 1] = std::thread(&DataParallel::work, this, i);
+            }
+        }
+
+        DataParallel(const DataParallel&) = delete;
+        DataParallel& operator=(const DataParallel&) = delete;
+
+        /**
+         * @brief Stop and join the worker threads
+         */
+        ~DataParallel() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_stepReady.notify_all();
+            for (auto &worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        /**
+         * @brief Perform a training step on all replicas concurrently, and update the weights of the Net using the
+         *        average of their gradients once enough steps have been accumulated. If the step function throws on any
+         *        replica, the exception is rethrown and the gradients of all replicas are discarded
+         * @tparam Step The type of the step function
+         * @param step Function called as step(replica, replicaIndex) on the thread of every replica. It must call
+         *        replica.forward() and replica.computeGradients() on the share of the data given by replicaIndex
+         */
+        template<typename Step>
+        void step(Step && step) {
+            // Synchronize all replicas with the current weights of the Net
+            for (auto &replica : m_replicas) {
+                replica.copyWeights(m_net);
+            }
+
+            // Compute gradients on all replicas concurrently, using the calling thread for the first replica
+            using StepType = typename std::remove_reference<Step>::type;
+            m_errors.fill(nullptr);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_run = &DataParallel::runStep<StepType>;
+                m_step = const_cast<void*>(static_cast<const void*>(&step));
+                m_pending = NumReplicas - 1;
+                m_generation++;
+            }
+            m_stepReady.notify_all();
+            run(step, 0, m_errors[0]);
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_stepDone.wait(lock, [this] { return m_pending == 0; });
+            }
+            for (const auto &error : m_errors) {
+                if (error) {
+                    // Discard the gradients of the replicas that succeeded, so they aren't merged by the next step
+                    for (auto &replica : m_replicas) {
+                        replica.clearGradients();
+                    }
+                    std::rethrow_exception(error);
+                }
+            }
+
+            // Merge gradients in a fixed order, and apply them once enough steps have been accumulated
+            for (auto &replica : m_replicas) {
+                m_net.mergeGradients(replica);
+            }
+            if (m_net.accumulatedSteps() >= m_net.gradientAccumulation()) {
+                m_net.applyGradients();
+            }
+        }
+
+        /**
+         * @brief Get a replica of the Net
+         * @param index The index of the replica
+         * @return The replica
+         */
+        NetType& replica(unsigned int index) {
+            return m_replicas[index];
+        }
+
+    private:
+        /**
+         * @brief Loop of a worker thread, which runs the step function on its replica every time a step is started
+         * @param index The index of the replica of the worker
+         */
+        void work(unsigned int index) {
+            unsigned int generation = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_stepReady.wait(lock, [&] { return m_stopping || m_generation != generation; });
+                    if (m_stopping) {
+                        return;
+                    }
+                    generation = m_generation;
+                }
+                m_run(*this, m_step, index);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pending--;
+                }
+                m_stepDone.notify_one();
+            }
+        }
+
+        /**
+         * @brief Run the step function of the current step, whose type has been erased so it can be handed to the
+         *        worker threads without allocating
+         * @tparam Step The type of the step function
+         * @param self The trainer
+         * @param step The step function
+         * @param index The index of the replica
+         */
+        template<typename Step>
+        static void runStep(DataParallel &self, void *step, unsigned int index) {
+            self.run(*static_cast<Step*>(step), index, self.m_errors[index]);
+        }
+
+        /**
+         * @brief Run the step function on a replica, capturing any exception so it can be rethrown on the calling thread
+         * @tparam Step The type of the step function
+         * @param step The step function
+         * @param index The index of the replica
+         * @param error [out]: The exception thrown by the step function, if any
+         */
+        template<typename Step>
+        void run(Step &step, unsigned int index, std::exception_ptr &error) {
+            try {
+                step(m_replicas[index], index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        NetType &m_net;                                 ///< The Net being trained
+        std::array<NetType, NumReplicas> m_replicas;    ///< The replicas computing gradients, one per thread
+        std::array<std::exception_ptr, NumReplicas> m_errors;  ///< The exception thrown on every replica in the current step
+        std::array<std::thread, NumReplicas - 1> m_workers;    ///< The worker threads of all replicas but the first
+        std::mutex m_mutex;                             ///< Guards the state shared with the worker threads
+        std::condition_variable m_stepReady;            ///< Signalled when a step is started or the workers are stopped
+        std::condition_variable m_stepDone;             ///< Signalled when a worker has finished its replica's step
+        void (*m_run)(DataParallel&, void*, unsigned int) = nullptr;   ///< Runs the step function of the current step
+        void *m_step = nullptr;                         ///< The step function of the current step
+        unsigned int m_generation = 0;                  ///< The number of steps started, which the workers wait to change
+        unsigned int m_pending = 0;                     ///< The number of workers that haven't finished the current step
+        bool m_stopping = false;                        ///< Whether the workers have been asked to stop
+    };
+}
+
+#endif //NEURAL_DATAPARALLEL_HPP
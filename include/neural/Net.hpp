@@ -12,7 +12,10 @@
 
 #include <tuple>
 #include <unsupported/Eigen/CXX11/Tensor>
+#include <algorithm>
 #include <cstddef>
+#include <memory>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -21,6 +24,119 @@
 
 namespace neural {
     namespace detail {
+        /**
+         * @brief Whether a layer can overwrite its input with its output in forward(), i.e. has forwardInPlace(), and
+         *        the input is a temporary rather than a reference to a tensor that is still needed
+         * @tparam Layer The type of the layer
+         * @tparam Input The type of the input to the layer
+         */
+        template<typename Layer, typename Input, typename = void>
+        struct ForwardsInPlace : std::false_type {};
+
+        template<typename Layer, typename Input>
+        struct ForwardsInPlace<Layer, Input, decltype(std::declval<Layer&>().forwardInPlace(std::declval<Input&>()))>
+                : std::integral_constant<bool, !std::is_reference<Input>::value> {};
+
+        /**
+         * @brief Whether a layer can overwrite its input with its output in predict() (see ForwardsInPlace)
+         * @tparam Layer The type of the layer
+         * @tparam Input The type of the input to the layer
+         */
+        template<typename Layer, typename Input, typename = void>
+        struct PredictsInPlace : std::false_type {};
+
+        template<typename Layer, typename Input>
+        struct PredictsInPlace<Layer, Input, decltype(std::declval<Layer&>().predictInPlace(std::declval<Input&>()))>
+                : std::integral_constant<bool, !std::is_reference<Input>::value> {};
+
+        /**
+         * @brief Whether a layer applies an elementwise function, which can be fused with the functions of adjacent
+         *        elementwise layers. Such layers provide the function as Function (see Activation.hpp), which is void
+         *        when the layer can't be fused, e.g. when it uses an approximation of its function
+         * @tparam Layer The type of the layer
+         */
+        template<typename Layer, typename = void>
+        struct IsElementwise : std::false_type {};
+
+        template<typename Layer>
+        struct IsElementwise<Layer, typename std::conditional<true, void, typename Layer::Function>::type>
+                : std::integral_constant<bool, !std::is_void<typename Layer::Function>::value> {};
+
+        /**
+         * @brief The number of consecutive elementwise layers at the top of the first N layers of a stack
+         * @tparam Layers The type of the tuple of layers
+         * @tparam N The number of layers to consider
+         */
+        template<typename Layers, size_t N>
+        struct ElementwiseRun : std::integral_constant<size_t,
+                IsElementwise<typename std::tuple_element<N-1, Layers>::type>::value ? ElementwiseRun<Layers, N-1>::value + 1 : 0> {};
+
+        template<typename Layers>
+        struct ElementwiseRun<Layers, 0> : std::integral_constant<size_t, 0> {};
+
+        /**
+         * @brief Whether the layer at the top of the first N layers of a stack ends a run of elementwise layers that
+         *        is fused into a single pass. Auto diff scalars are never fused, as they record a node per function
+         * @tparam Layers The type of the tuple of layers
+         * @tparam N The number of layers to consider
+         * @tparam Scalar The scalar type of the activations
+         */
+        template<typename Layers, size_t N, typename Scalar>
+        using FusesElementwise = std::integral_constant<bool, (ElementwiseRun<Layers, N>::value > 1) && IsNative<Scalar>::value>;
+
+        /**
+         * @brief The functions of the layers [Begin, End) of a stack, applied one after another to a block of
+         *        activations that stays in the L1 cache
+         * Composing all the functions into a single Eigen expression is faster still for cheap functions such as Relu,
+         * but compilers handle nested transcendental packet functions so poorly that chains of tanh and sigmoid end up
+         * slower than separate passes, whereas a pass per function over a cached block is never slower
+         * @tparam Layers The type of the tuple of layers
+         * @tparam Begin The index of the first layer
+         * @tparam End The index after the last layer
+         */
+        template<typename Layers, size_t Begin, size_t End>
+        struct FusedFunction {
+            template<typename Block>
+            static void apply(Block &block) {
+                FusedFunction<Layers, Begin, End-1>::apply(block);
+                block = std::tuple_element<End-1, Layers>::type::Function::apply(block);
+            }
+        };
+
+        /**
+         * @brief FusedFunction specialization for the base case, the identity
+         */
+        template<typename Layers, size_t Begin>
+        struct FusedFunction<Layers, Begin, Begin> {
+            template<typename Block>
+            static void apply(Block &block) {
+                // Noop
+            }
+        };
+
+        /**
+         * @brief Apply the functions of the layers [Begin, End) of a stack to a tensor in place, so every activation is
+         *        read from and written to memory once instead of once per layer
+         * @tparam Layers The type of the tuple of layers
+         * @tparam Begin The index of the first layer
+         * @tparam End The index after the last layer
+         * @tparam TensorType The type of the tensor
+         * @param tensor [in, out]: The input to the first layer, which is replaced by the output of the last layer
+         */
+        template<typename Layers, size_t Begin, size_t End, typename TensorType>
+        inline void applyFused(TensorType &tensor) {
+            using Scalar = typename TensorType::Scalar;
+            constexpr Eigen::Index size = Eigen::Index(TensorType::BatchSize) * TensorType::ChannelSize;
+            // Blocks of 16 KiB leave room in the L1 cache for the constants and spills of the functions
+            constexpr Eigen::Index blockSize = 16384 / sizeof(Scalar);
+
+            Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1>> activations(tensor.data(), size);
+            for (Eigen::Index i = 0; i < size; i += blockSize) {
+                auto block = activations.segment(i, std::min(blockSize, size - i));
+                FusedFunction<Layers, Begin, End>::apply(block);
+            }
+        }
+
         /**
          * @brief Struct used to recurse calls up or down a stack of layers at compile-time
          * @tparam N The number of steps to recurse
@@ -28,15 +144,107 @@ namespace neural {
         template<size_t N>
         struct Recursor {
             template<typename Input, typename Layers>
-            static inline auto update(Input && input, Layers && layers)
+            static inline auto update(Input && input, Layers && layers, std::false_type /*fused*/, std::false_type /*inPlace*/)
             -> decltype(std::get<N-1>(std::forward<Layers>(layers)).forward(Recursor<N-1>::update(std::forward<Input>(input), std::forward<Layers>(layers)))) {
                 return std::get<N-1>(std::forward<Layers>(layers)).forward(Recursor<N-1>::update(std::forward<Input>(input), std::forward<Layers>(layers)));
             }
 
+            /**
+             * @brief Overwrite the temporary output of the layers below with the output of the top layer, which is then
+             *        returned without a copy
+             */
+            template<typename Input, typename Layers>
+            static inline auto update(Input && input, Layers && layers, std::false_type /*fused*/, std::true_type /*inPlace*/)
+            -> decltype(Recursor<N-1>::update(std::forward<Input>(input), std::forward<Layers>(layers))) {
+                auto output = Recursor<N-1>::update(std::forward<Input>(input), std::forward<Layers>(layers));
+                std::get<N-1>(std::forward<Layers>(layers)).forwardInPlace(output);
+                return output;
+            }
+
+            /**
+             * @brief Apply the top layer and the elementwise layers below it, down to the first layer that isn't
+             *        elementwise, in a single pass over the output of that layer
+             */
+            template<typename Input, typename Layers, typename InPlace>
+            static inline typename std::tuple_element<N-1, typename std::decay<Layers>::type>::type::OutputTensor
+            update(Input && input, Layers && layers, std::true_type /*fused*/, InPlace) {
+                using LayerTuple = typename std::decay<Layers>::type;
+                constexpr size_t begin = N - ElementwiseRun<LayerTuple, N>::value;
+                typename std::tuple_element<N-1, LayerTuple>::type::OutputTensor output =
+                        Recursor<begin>::update(std::forward<Input>(input), std::forward<Layers>(layers));
+                applyFused<LayerTuple, begin, N>(output);
+                return output;
+            }
+
+            template<typename Input, typename Layers>
+            static inline auto update(Input && input, Layers && layers)
+            -> decltype(Recursor::update(std::forward<Input>(input), std::forward<Layers>(layers),
+                    FusesElementwise<typename std::decay<Layers>::type, N, typename std::tuple_element<N-1, typename std::decay<Layers>::type>::type::OutputTensor::Scalar>(),
+                    ForwardsInPlace<typename std::remove_reference<decltype(std::get<N-1>(layers))>::type, decltype(Recursor<N-1>::update(std::forward<Input>(input), std::forward<Layers>(layers)))>())) {
+                return update(std::forward<Input>(input), std::forward<Layers>(layers),
+                        FusesElementwise<typename std::decay<Layers>::type, N, typename std::tuple_element<N-1, typename std::decay<Layers>::type>::type::OutputTensor::Scalar>(),
+                        ForwardsInPlace<typename std::remove_reference<decltype(std::get<N-1>(layers))>::type, decltype(Recursor<N-1>::update(std::forward<Input>(input), std::forward<Layers>(layers)))>());
+            }
+
+            template<typename Input, typename Layers>
+            static inline auto predict(Input && input, Layers && layers, std::false_type /*fused*/, std::false_type /*inPlace*/)
+            -> decltype(std::get<N-1>(std::forward<Layers>(layers)).predict(Recursor<N-1>::predict(std::forward<Input>(input), std::forward<Layers>(layers)))) {
+                return std::get<N-1>(std::forward<Layers>(layers)).predict(Recursor<N-1>::predict(std::forward<Input>(input), std::forward<Layers>(layers)));
+            }
+
+            /**
+             * @brief Overwrite the temporary output of the layers below with the plain value output of the top layer
+             */
+            template<typename Input, typename Layers>
+            static inline auto predict(Input && input, Layers && layers, std::false_type /*fused*/, std::true_type /*inPlace*/)
+            -> decltype(Recursor<N-1>::predict(std::forward<Input>(input), std::forward<Layers>(layers))) {
+                auto output = Recursor<N-1>::predict(std::forward<Input>(input), std::forward<Layers>(layers));
+                std::get<N-1>(std::forward<Layers>(layers)).predictInPlace(output);
+                return output;
+            }
+
+            /**
+             * @brief Apply the top layer and the elementwise layers below it, down to the first layer that isn't
+             *        elementwise, in a single pass over the output of that layer
+             */
+            template<typename Input, typename Layers, typename InPlace>
+            static inline typename std::tuple_element<N-1, typename std::decay<Layers>::type>::type::ValueOutputTensor
+            predict(Input && input, Layers && layers, std::true_type /*fused*/, InPlace) {
+                using LayerTuple = typename std::decay<Layers>::type;
+                constexpr size_t begin = N - ElementwiseRun<LayerTuple, N>::value;
+                typename std::tuple_element<N-1, LayerTuple>::type::ValueOutputTensor output =
+                        Recursor<begin>::predict(std::forward<Input>(input), std::forward<Layers>(layers));
+                applyFused<LayerTuple, begin, N>(output);
+                return output;
+            }
+
+            template<typename Input, typename Layers>
+            static inline auto predict(Input && input, Layers && layers)
+            -> decltype(Recursor::predict(std::forward<Input>(input), std::forward<Layers>(layers),
+                    FusesElementwise<typename std::decay<Layers>::type, N, typename std::tuple_element<N-1, typename std::decay<Layers>::type>::type::ValueOutputTensor::Scalar>(),
+                    PredictsInPlace<typename std::remove_reference<decltype(std::get<N-1>(layers))>::type, decltype(Recursor<N-1>::predict(std::forward<Input>(input), std::forward<Layers>(layers)))>())) {
+                return predict(std::forward<Input>(input), std::forward<Layers>(layers),
+                        FusesElementwise<typename std::decay<Layers>::type, N, typename std::tuple_element<N-1, typename std::decay<Layers>::type>::type::ValueOutputTensor::Scalar>(),
+                        PredictsInPlace<typename std::remove_reference<decltype(std::get<N-1>(layers))>::type, decltype(Recursor<N-1>::predict(std::forward<Input>(input), std::forward<Layers>(layers)))>());
+            }
+
+            template<typename Input, typename Layers, typename Activations>
+            static inline void record(Input && input, Layers && layers, Activations && activations) {
+                Recursor<N-1>::record(std::forward<Input>(input), std::forward<Layers>(layers), std::forward<Activations>(activations));
+                std::get<N>(activations) = std::get<N-1>(std::forward<Layers>(layers)).forward(std::get<N-1>(activations));
+            }
+
+            template<typename Gradient, typename Layers, typename Activations>
+            static inline auto propagate(const Gradient &gradOutput, Layers && layers, Activations && activations)
+            -> decltype(Recursor<N-1>::propagate(std::get<N-1>(std::forward<Layers>(layers)).backward(std::get<N-1>(activations), std::get<N>(activations), gradOutput), std::forward<Layers>(layers), std::forward<Activations>(activations))) {
+                const auto gradInput = std::get<N-1>(std::forward<Layers>(layers)).backward(std::get<N-1>(activations), std::get<N>(activations), gradOutput);
+                return Recursor<N-1>::propagate(gradInput, std::forward<Layers>(layers), std::forward<Activations>(activations));
+            }
+
             template<typename Layers>
-            static inline void backward(Layers && layers) {
-                std::get<N-1>(std::forward<Layers>(layers)).updateWeights();
-                Recursor<N-1>::backward(std::forward<Layers>(layers));
+            static inline void backward(Layers && layers, double gradientScale) {
+                std::get<N-1>(std::forward<Layers>(layers)).updateWeights(gradientScale);
+                Recursor<N-1>::backward(std::forward<Layers>(layers), gradientScale);
             }
 
             template<typename Layers>
@@ -44,6 +252,30 @@ namespace neural {
                 std::get<N-1>(std::forward<Layers>(layers)).attachOptimizer(std::forward<OptimizerFactory>(factory));
                 Recursor<N-1>::attach(std::forward<OptimizerFactory>(factory), std::forward<Layers>(layers));
             }
+
+            template<typename Layers, typename Replicas>
+            static inline void merge(Layers && layers, Replicas && replicas) {
+                std::get<N-1>(std::forward<Layers>(layers)).mergeGradients(std::get<N-1>(std::forward<Replicas>(replicas)));
+                Recursor<N-1>::merge(std::forward<Layers>(layers), std::forward<Replicas>(replicas));
+            }
+
+            template<typename Layers>
+            static inline void clear(Layers && layers) {
+                std::get<N-1>(std::forward<Layers>(layers)).clearGradients();
+                Recursor<N-1>::clear(std::forward<Layers>(layers));
+            }
+
+            template<typename Layers, typename Sources>
+            static inline void copy(Layers && layers, Sources && sources) {
+                std::get<N-1>(std::forward<Layers>(layers)).copyWeights(std::get<N-1>(std::forward<Sources>(sources)));
+                Recursor<N-1>::copy(std::forward<Layers>(layers), std::forward<Sources>(sources));
+            }
+
+            template<typename Layers>
+            static inline void freeze(Layers && layers, bool frozen) {
+                std::get<N-1>(std::forward<Layers>(layers)).freeze(frozen);
+                Recursor<N-1>::freeze(std::forward<Layers>(layers), frozen);
+            }
         };
 
         /**
@@ -56,8 +288,23 @@ namespace neural {
                 return input;
             }
 
+            template<typename Input, typename Layers>
+            static inline Input predict(Input && input, Layers && layers) {
+                return input;
+            }
+
+            template<typename Input, typename Layers, typename Activations>
+            static inline void record(Input && input, Layers && layers, Activations && activations) {
+                std::get<0>(activations) = input;
+            }
+
+            template<typename Gradient, typename Layers, typename Activations>
+            static inline Gradient propagate(const Gradient &gradOutput, Layers && layers, Activations && activations) {
+                return gradOutput;
+            }
+
             template<typename Layers>
-            static inline void backward(Layers && layers) {
+            static inline void backward(Layers && layers, double gradientScale) {
                 // Noop
             }
 
@@ -65,6 +312,26 @@ namespace neural {
             static inline void attach(OptimizerFactory && factory, Layers && layers) {
                 // Noop
             }
+
+            template<typename Layers, typename Replicas>
+            static inline void merge(Layers && layers, Replicas && replicas) {
+                // Noop
+            }
+
+            template<typename Layers>
+            static inline void clear(Layers && layers) {
+                // Noop
+            }
+
+            template<typename Layers, typename Sources>
+            static inline void copy(Layers && layers, Sources && sources) {
+                // Noop
+            }
+
+            template<typename Layers>
+            static inline void freeze(Layers && layers, bool frozen) {
+                // Noop
+            }
         };
 
         /**
@@ -81,14 +348,60 @@ namespace neural {
             return Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::update(std::forward<Input>(input), std::forward<Layers>(layers));
         }
 
+        /**
+         * @brief Recursively call the predict functions of all layers, chaining plain values throughout the stack
+         * @tparam Input The type of the input
+         * @tparam Layers The types of the layers
+         * @param input The input to the layer stack
+         * @param layers The layers
+         * @return The output from the final layer
+         */
+        template<typename Input, typename Layers>
+        inline auto predict(Input && input, Layers && layers)
+        -> decltype(Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::predict(std::forward<Input>(input), std::forward<Layers>(layers))) {
+            return Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::predict(std::forward<Input>(input), std::forward<Layers>(layers));
+        }
+
+        /**
+         * @brief Recursively call the forward functions of all layers, storing the input and output of every layer
+         * @tparam Input The type of the input
+         * @tparam Layers The types of the layers
+         * @tparam Activations The type of the tuple used to store the activations
+         * @param input The input to the layer stack
+         * @param layers The layers
+         * @param activations [out]: The input to each layer followed by the output of the final layer
+         */
+        template<typename Input, typename Layers, typename Activations>
+        inline void record(Input && input, Layers && layers, Activations && activations) {
+            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::record(std::forward<Input>(input), std::forward<Layers>(layers), std::forward<Activations>(activations));
+        }
+
+        /**
+         * @brief Recursively call the native backward functions of all layers, chaining output gradients to input
+         *        gradients from the top of the stack to the bottom
+         * @tparam Gradient The type of the gradient with respect to the output of the final layer
+         * @tparam Layers The types of the layers
+         * @tparam Activations The type of the tuple storing the activations
+         * @param gradOutput The gradient of the loss with respect to the output of the final layer
+         * @param layers The layers
+         * @param activations The activations stored by record()
+         * @return The gradient of the loss with respect to the input of the first layer
+         */
+        template<typename Gradient, typename Layers, typename Activations>
+        inline auto propagate(const Gradient &gradOutput, Layers && layers, Activations && activations)
+        -> decltype(Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::propagate(gradOutput, std::forward<Layers>(layers), std::forward<Activations>(activations))) {
+            return Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::propagate(gradOutput, std::forward<Layers>(layers), std::forward<Activations>(activations));
+        }
+
         /**
          * @brief Call the backward functions of all layers
          * @tparam Layers The types of the layers
          * @param layers The layers
+         * @param gradientScale Factor applied to the accumulated gradients before the weights are updated
          */
         template<typename Layers>
-        inline void backward(Layers && layers) {
-            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::backward(std::forward<Layers>(layers));
+        inline void backward(Layers && layers, double gradientScale = 1.0) {
+            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::backward(std::forward<Layers>(layers), gradientScale);
         }
 
         /**
@@ -101,6 +414,51 @@ namespace neural {
         inline void attach(OptimizerFactory && factory, Layers && layers) {
             Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::attach(std::forward<OptimizerFactory>(factory), std::forward<Layers>(layers));
         }
+
+        /**
+         * @brief Add the accumulated gradients of all layers of a replica to the corresponding layers, and reset them
+         * @tparam Layers The types of the layers
+         * @tparam Replicas The types of the layers of the replica
+         * @param layers The layers
+         * @param replicas The layers of the replica
+         */
+        template<typename Layers, typename Replicas>
+        inline void merge(Layers && layers, Replicas && replicas) {
+            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::merge(std::forward<Layers>(layers), std::forward<Replicas>(replicas));
+        }
+
+        /**
+         * @brief Discard the accumulated gradients of all layers
+         * @tparam Layers The types of the layers
+         * @param layers The layers
+         */
+        template<typename Layers>
+        inline void clear(Layers && layers) {
+            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::clear(std::forward<Layers>(layers));
+        }
+
+        /**
+         * @brief Copy the weights of all layers from a corresponding set of layers
+         * @tparam Layers The types of the layers
+         * @tparam Sources The types of the layers to copy from
+         * @param layers The layers
+         * @param sources The layers to copy from
+         */
+        template<typename Layers, typename Sources>
+        inline void copy(Layers && layers, Sources && sources) {
+            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::copy(std::forward<Layers>(layers), std::forward<Sources>(sources));
+        }
+
+        /**
+         * @brief Freeze or unfreeze the weights of all layers
+         * @tparam Layers The types of the layers
+         * @param layers The layers
+         * @param frozen Whether to freeze the weights
+         */
+        template<typename Layers>
+        inline void freeze(Layers && layers, bool frozen) {
+            Recursor<std::tuple_size<typename std::decay<Layers>::type>::value>::freeze(std::forward<Layers>(layers), frozen);
+        }
     }
 
     /**
@@ -113,6 +471,16 @@ namespace neural {
         using InputTensor = typename std::tuple_element<0, std::tuple<Layers...>>::type::InputTensor;
         using OutputTensor = typename std::tuple_element<std::tuple_size<std::tuple<Layers...>>::value-1, std::tuple<Layers...>>::type::OutputTensor;
         using Dtype = typename InputTensor::Scalar;
+        using ValueInputTensor = typename std::tuple_element<0, std::tuple<Layers...>>::type::ValueInputTensor;
+        using ValueOutputTensor = typename std::tuple_element<std::tuple_size<std::tuple<Layers...>>::value-1, std::tuple<Layers...>>::type::ValueOutputTensor;
+
+        /// The input to every layer followed by the output of the final layer, stored for native backpropagation. It is
+        /// only allocated once gradients are enabled, so a Net used for inference carries no activations at all
+        using Activations = typename std::conditional<IsNative<Dtype>::value,
+                std::tuple<typename Layers::InputTensor..., OutputTensor>, std::tuple<>>::type;
+
+        /// The persistent arena used for auto diff training steps
+        using Arena = typename std::conditional<std::is_same<Dtype, Derivative>::value, GradientArena, std::tuple<>>::type;
 
         /**
          * @brief Create a new Net from a set of layers
@@ -120,13 +488,29 @@ namespace neural {
          */
         explicit Net(Layers&&... layers): m_layers(std::make_tuple(std::forward<Layers>(layers)...)) {}
 
+        /**
+         * @brief Create a new Net from default constructed layers, e.g. for use as a replica of another Net
+         */
+        Net() = default;
+
         /**
          * @brief Propagate a given input throughout all the layers of the network and return the output
          * @param input The input to the Net
          * @return The output of the Net
          */
         OutputTensor forward(const InputTensor &input) {
-            return detail::update(input, m_layers);
+            return forwardImpl(input);
+        }
+
+        /**
+         * @brief Propagate a given input throughout all the layers of the network using plain values. This never records
+         *        gradients, so an auto diff Net evaluates its trained weights at inference-only speed, and a native Net
+         *        leaves the activations stored for backward() untouched
+         * @param input The input to the Net
+         * @return The output of the Net
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return detail::predict(input, m_layers);
         }
 
         /**
@@ -134,9 +518,32 @@ namespace neural {
          * @param factory The OptimizerFactory to use for creating optimizers
          */
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type attachOptimizer(OptimizerFactory && factory) {
+        typename std::enable_if<IsTrainable<Q>::value, void>::type attachOptimizer(OptimizerFactory && factory) {
             detail::attach(std::forward<OptimizerFactory>(factory), m_layers);
             m_optimizerAttached = true;
+            enableGradients();
+        }
+
+        /**
+         * @brief Make forward() store the activations needed by computeGradients() without attaching optimizers. This
+         *        is used for replicas that only compute gradients, which are merged into and applied by another Net
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type enableGradients() {
+            m_gradientsEnabled = true;
+            if (IsNative<Q>::value && !m_activations) {
+                m_activations.reset(new Activations());
+            }
+        }
+
+        /**
+         * @brief Get the persistent arena used for recording the auto diff tapes of this Net's training steps, to be
+         *        passed to a GradientGuard
+         * @return The arena of this Net
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<std::is_same<Q, Derivative>::value, GradientArena&>::type arena() {
+            return m_arena;
         }
 
         /**
@@ -149,16 +556,183 @@ namespace neural {
                 throw std::runtime_error("No optimizer attached - cannot perform backwards pass");
             }
 
-            // Compute and store partial derivatives with respect to the loss
+            // Perform weight updates once enough gradients have been accumulated
+            computeGradients(loss);
+            if (m_accumulatedSteps == m_accumulationSteps) {
+                applyGradients();
+            }
+        }
+
+        /**
+         * @brief Use the gradient of the loss with respect to the output of the last forward() call to perform native
+         *        backpropagation through all layers and update weights
+         * @param gradOutput The gradient of the loss with respect to the output of the Net, e.g. from loss.gradient()
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, void>::type backward(const OutputTensor &gradOutput) {
+            if (!m_optimizerAttached) {
+                throw std::runtime_error("No optimizer attached - cannot perform backwards pass");
+            }
+
+            // Perform weight updates once enough gradients have been accumulated
+            computeGradients(gradOutput);
+            if (m_accumulatedSteps == m_accumulationSteps) {
+                applyGradients();
+            }
+        }
+
+        /**
+         * @brief Use the provided loss to compute gradients for all layers, which are accumulated without updating weights
+         * @param loss The loss to use for calculating gradients
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type computeGradients(Q &loss) {
+            // Compute partial derivatives with respect to the loss, which are accumulated in the layers
             loss.grad();
+            m_accumulatedSteps++;
+        }
+
+        /**
+         * @brief Use the gradient of the loss with respect to the output of the last forward() call to compute gradients
+         *        for all layers using native backpropagation, which are accumulated without updating weights
+         * @param gradOutput The gradient of the loss with respect to the output of the Net, e.g. from loss.gradient()
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, void>::type computeGradients(const OutputTensor &gradOutput) {
+            if (!m_gradientsEnabled) {
+                throw std::runtime_error("Gradients not enabled - no activations were stored by forward()");
+            }
+
+            // Compute and accumulate gradients in all layers, from the top of the stack to the bottom
+            detail::propagate(gradOutput, m_layers, *m_activations);
+            m_accumulatedSteps++;
+        }
 
-            // Perform weight updates
-            detail::backward(m_layers);
+        /**
+         * @brief Add the gradients accumulated by a replica of this Net to the gradients of this Net, and reset the
+         *        gradients of the replica. Every step accumulated by the replica counts as a step of this Net when
+         *        averaging gradients in applyGradients()
+         * @param replica The replica to merge gradients from
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type mergeGradients(Net &replica) {
+            detail::merge(m_layers, replica.m_layers);
+            m_accumulatedSteps += replica.m_accumulatedSteps;
+            replica.m_accumulatedSteps = 0;
+        }
+
+        /**
+         * @brief Discard the gradients accumulated since the last update without updating weights, e.g. after a failed
+         *        training step
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type clearGradients() {
+            detail::clear(m_layers);
+            m_accumulatedSteps = 0;
+        }
+
+        /**
+         * @brief Copy the weights of another Net with the same layers, e.g. to synchronize a replica with this Net
+         * @param source The Net to copy weights from
+         */
+        void copyWeights(const Net &source) {
+            detail::copy(m_layers, source.m_layers);
+        }
+
+        /**
+         * @brief Get a layer of this Net, e.g. for converting a trained layer (see QuantizedLinear)
+         * @tparam Index The index of the layer
+         * @return The layer
+         */
+        template<size_t Index>
+        const typename std::tuple_element<Index, std::tuple<Layers...>>::type& layer() const {
+            return std::get<Index>(m_layers);
+        }
+
+        /**
+         * @brief Freeze or unfreeze the weights of all layers, e.g. once training has finished. Frozen layers repack their
+         *        weights once for faster inference, and are no longer updated by backward()
+         * @param frozen Whether to freeze the weights
+         */
+        void freeze(bool frozen = true) {
+            detail::freeze(m_layers, frozen);
+        }
+
+        /**
+         * @brief Accumulate gradients over a number of backward() calls before the weights are updated. This trains
+         *        with an effective batch size of numSteps * BatchSize, while every step only works on tensors of the
+         *        compile-time BatchSize. The accumulated gradients are averaged over the number of steps
+         * @param numSteps The number of backward() calls per weight update (1 updates weights on every call)
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type setGradientAccumulation(unsigned int numSteps) {
+            if (numSteps == 0) {
+                throw std::runtime_error("Gradients must be accumulated over at least one step");
+            }
+            m_accumulationSteps = numSteps;
+            if (m_accumulatedSteps >= m_accumulationSteps) {
+                applyGradients();
+            }
+        }
+
+        /**
+         * @brief Get the number of backward() calls gradients are accumulated over before the weights are updated
+         * @return The number of steps set by setGradientAccumulation()
+         */
+        unsigned int gradientAccumulation() const {
+            return m_accumulationSteps;
+        }
+
+        /**
+         * @brief Get the number of backward() calls whose gradients have been accumulated since the last update
+         * @return The number of accumulated steps
+         */
+        unsigned int accumulatedSteps() const {
+            return m_accumulatedSteps;
+        }
+
+        /**
+         * @brief Update weights using the gradients accumulated since the last update, averaged over the number of
+         *        backward() calls they were accumulated over. Use this to apply the remaining gradients at the end of
+         *        an epoch that isn't a multiple of the accumulation steps. Does nothing if no gradients are pending
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type applyGradients() {
+            if (m_accumulatedSteps == 0) {
+                return;
+            }
+            detail::backward(m_layers, 1.0 / m_accumulatedSteps);
+            m_accumulatedSteps = 0;
         }
 
     private:
+        /**
+         * @brief Forward pass for native training, which stores activations for backward() once gradients are enabled
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, OutputTensor>::type forwardImpl(const InputTensor &input) {
+            if (!m_gradientsEnabled) {
+                return detail::update(input, m_layers);
+            }
+            detail::record(input, m_layers, *m_activations);
+            return std::get<sizeof...(Layers)>(*m_activations);
+        }
+
+        /**
+         * @brief Forward pass for inference and for auto diff, where gradients are tracked by the scalar type itself
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<!IsNative<Q>::value, OutputTensor>::type forwardImpl(const InputTensor &input) {
+            return detail::update(input, m_layers);
+        }
+
         std::tuple<Layers...> m_layers;     ///< The stack of layers wrapped by this Net
+        std::unique_ptr<Activations> m_activations; ///< Activations stored during forward() for native backpropagation (null until gradients are enabled)
+        Arena m_arena;                      ///< Arena for recording auto diff training steps
         bool m_optimizerAttached = false;   ///< Whether an optimizer has been attached to the layers of this Net
+        bool m_gradientsEnabled = false;    ///< Whether forward() stores the activations needed for computing gradients
+        unsigned int m_accumulationSteps = 1;   ///< The number of backward() calls to accumulate gradients over
+        unsigned int m_accumulatedSteps = 0;    ///< The number of backward() calls accumulated since the last update
     };
 
     /**
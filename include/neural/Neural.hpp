@@ -12,20 +12,36 @@
 
 #include <neural/Tensor.hpp>
 #include <neural/Net.hpp>
+#include <neural/DataParallel.hpp>
 
+#include <neural/layers/Checkpoint.hpp>
+#include <neural/layers/Elementwise.hpp>
 #include <neural/layers/Linear.hpp>
+#include <neural/layers/LowRankLinear.hpp>
+#include <neural/layers/QuantizedLinear.hpp>
 #include <neural/layers/Relu.hpp>
 #include <neural/layers/Sigmoid.hpp>
 #include <neural/layers/Softmax.hpp>
+#include <neural/layers/SparseLinear.hpp>
 #include <neural/layers/Tanh.hpp>
 #include <neural/losses/CrossEntropy.hpp>
 #include <neural/losses/MeanSquaredError.hpp>
+#include <neural/losses/SoftmaxCrossEntropy.hpp>
+#include <neural/losses/SparseCrossEntropy.hpp>
 
 #include <neural/optimizers/SGD.hpp>
 #include <neural/optimizers/Adam.hpp>
 
+#include <neural/util/Activation.hpp>
+#include <neural/util/Cpu.hpp>
+#include <neural/util/FastMath.hpp>
+#include <neural/util/Gemm.hpp>
 #include <neural/util/Gradient.hpp>
 #include <neural/util/Mapping.hpp>
+#include <neural/util/Metrics.hpp>
+#include <neural/util/Quantization.hpp>
 #include <neural/util/RNG.hpp>
+#include <neural/util/SparseGemm.hpp>
+#include <neural/util/Storage.hpp>
 
 #endif //NEURAL_NEURAL_HPP
@@ -0,0 +1,144 @@
+/**
+* \file Checkpoint.hpp
+*
+* \brief Layer wrapping a segment of layers, whose intermediate activations are recomputed during native
+*        backpropagation instead of being stored
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_CHECKPOINT_HPP
+#define NEURAL_CHECKPOINT_HPP
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <neural/Net.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/optimizers/OptimizerFactory.hpp>
+
+namespace neural {
+    /**
+     * @brief Layer wrapping a segment of layers, whose intermediate activations are recomputed during native
+     *        backpropagation instead of being stored
+     * A Net only stores the input and output of a Checkpoint for native backpropagation. During backward(), the
+     * segment is run forward again from its stored input to recreate the activations of the wrapped layers, which are
+     * only needed until the gradient has been propagated through the segment. They are recomputed into a heap buffer
+     * that is shared by all Checkpoints of the same type on a thread, so a deep stack of identical segments only ever
+     * holds the activations of one segment. Wrapping a deep stack in segments of k layers thereby trades one extra
+     * forward pass for storing only about 1/k of the activations.
+     * Auto diff and inference-only segments behave exactly like the wrapped layers.
+     * @tparam Layers The types of the layers in the segment
+     */
+    template<typename... Layers>
+    class Checkpoint {
+    public:
+        using InputTensor = typename std::tuple_element<0, std::tuple<Layers...>>::type::InputTensor;
+        using OutputTensor = typename std::tuple_element<sizeof...(Layers)-1, std::tuple<Layers...>>::type::OutputTensor;
+        using Dtype = typename InputTensor::Scalar;
+        using ValueInputTensor = typename std::tuple_element<0, std::tuple<Layers...>>::type::ValueInputTensor;
+        using ValueOutputTensor = typename std::tuple_element<sizeof...(Layers)-1, std::tuple<Layers...>>::type::ValueOutputTensor;
+
+        /// The input to every layer followed by the output of the final layer, recomputed during backward()
+        using Activations = std::tuple<typename Layers::InputTensor..., OutputTensor>;
+
+        /**
+         * @brief Create a new Checkpoint from a set of layers
+         * @param layers The layers to wrap in this Checkpoint
+         */
+        explicit Checkpoint(Layers&&... layers): m_layers(std::make_tuple(std::forward<Layers>(layers)...)) {}
+
+        /**
+         * @brief Create a new Checkpoint from default constructed layers
+         */
+        Checkpoint() = default;
+
+        OutputTensor forward(const InputTensor &input) {
+            return detail::update(input, m_layers);
+        }
+
+        /**
+         * @brief Inference pass on plain values, which never records gradients
+         * @param input The input to this segment
+         * @return The output of this segment
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return detail::predict(input, m_layers);
+        }
+
+        /**
+         * @brief Backpropagate a gradient through this segment using the native backpropagation engine, recomputing
+         *        the activations of the wrapped layers from the input of the segment
+         * @param input The input given to forward()
+         * @param output The output returned by forward()
+         * @param gradOutput The gradient of the loss with respect to the output of this segment
+         * @return The gradient of the loss with respect to the input of this segment
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type backward(const InputTensor &input, const OutputTensor &output, const OutputTensor &gradOutput) {
+            Activations &activations = recomputed();
+            detail::record(input, m_layers, activations);
+            return detail::propagate(gradOutput, m_layers, activations);
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
+            detail::attach(OptimizerFactory(factory), m_layers);
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type updateWeights(double gradientScale = 1.0) {
+            detail::backward(m_layers, gradientScale);
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type mergeGradients(Checkpoint &replica) {
+            detail::merge(m_layers, replica.m_layers);
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type clearGradients() {
+            detail::clear(m_layers);
+        }
+
+        void copyWeights(const Checkpoint &source) {
+            detail::copy(m_layers, source.m_layers);
+        }
+
+        void freeze(bool frozen = true) {
+            detail::freeze(m_layers, frozen);
+        }
+
+    private:
+        /**
+         * @brief Get the buffer the activations of the segment are recomputed into, allocating it on first use. The
+         *        buffer is reused by every backward() of Checkpoints of this type on the calling thread
+         * @return The buffer
+         */
+        static Activations& recomputed() {
+            static thread_local std::unique_ptr<Activations> activations;
+            if (!activations) {
+                activations.reset(new Activations());
+            }
+            return *activations;
+        }
+
+        std::tuple<Layers...> m_layers;     ///< The segment of layers wrapped by this Checkpoint
+    };
+
+    /**
+     * @brief Helper function to create a new Checkpoint with automatic template deduction
+     * @tparam Layers The types of the layers to wrap in a Checkpoint
+     * @param layers The layers to wrap in a Checkpoint
+     * @return The created Checkpoint
+     */
+    template<typename... Layers>
+    Checkpoint<typename std::decay<Layers>::type...> make_checkpoint(Layers&&... layers) {
+        typedef Checkpoint<typename std::decay<Layers>::type...> checkpoint_type;
+        return checkpoint_type(std::forward<Layers>(layers)...);
+    }
+}
+
+#endif //NEURAL_CHECKPOINT_HPP
@@ -0,0 +1,339 @@
+/**
+* \file Elementwise.hpp
+*
+* \brief Activation layer applying an elementwise function given by a functor, and the functors of common activations
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_ELEMENTWISE_HPP
+#define NEURAL_ELEMENTWISE_HPP
+
+#include <cmath>
+#include <type_traits>
+#include <Eigen/Core>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Mapping.hpp>
+#include <neural/Tensor.hpp>
+#include <neural/optimizers/OptimizerFactory.hpp>
+
+namespace neural {
+    /**
+     * @brief Functors of elementwise activation functions for the Elementwise layer
+     * Every functor provides:
+     *  - value(x), which computes y = f(x) on any scalar, including auto diff scalars
+     *  - derivative(x, y), which computes dy/dx from the input and output, for native backpropagation
+     *  - packet(x), which computes f on a SIMD packet of plain values using Eigen's packet math
+     */
+    namespace elementwise {
+        /**
+         * @brief Leaky rectified linear unit, y = x for x > 0 and 0.01x elsewhere
+         */
+        struct LeakyRelu {
+            template<typename Scalar>
+            static Scalar value(const Scalar &x) {
+                return x > 0 ? x : Scalar(0.01) * x;
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(const Scalar &x, const Scalar &/*y*/) {
+                return x > 0 ? Scalar(1) : Scalar(0.01);
+            }
+
+            template<typename Packet>
+            static Packet packet(const Packet &x) {
+                using namespace Eigen::internal;
+                using Scalar = typename unpacket_traits<Packet>::type;
+                return pmax(x, pmul(pset1<Packet>(Scalar(0.01)), x));
+            }
+        };
+
+        /**
+         * @brief Exponential linear unit (https://arxiv.org/abs/1511.07289), y = x for x > 0 and exp(x) - 1 elsewhere
+         */
+        struct Elu {
+            template<typename Scalar>
+            static Scalar value(const Scalar &x) {
+                using std::exp;
+                return x > 0 ? x : exp(x) - Scalar(1);
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(const Scalar &x, const Scalar &y) {
+                return x > 0 ? Scalar(1) : y + Scalar(1);
+            }
+
+            /**
+             * @brief Computed as max(x, 0) + exp(min(x, 0)) - 1, where exactly one of the terms is non-zero. This
+             *        avoids the comparison and select packet ops, which Eigen only provides generically from 3.4 on
+             */
+            template<typename Packet>
+            static Packet packet(const Packet &x) {
+                using namespace Eigen::internal;
+                using Scalar = typename unpacket_traits<Packet>::type;
+                const Packet zero = pset1<Packet>(Scalar(0));
+                const Packet negative = psub(pexp(pmin(x, zero)), pset1<Packet>(Scalar(1)));
+                return padd(pmax(x, zero), negative);
+            }
+        };
+
+        /**
+         * @brief Gaussian error linear unit (https://arxiv.org/abs/1606.08415) using the tanh approximation,
+         *        y = x * (1 + tanh(z)) / 2 with z = sqrt(2 / pi) * (x + 0.044715x^3), computed as x * sigmoid(2z)
+         */
+        struct Gelu {
+            template<typename Scalar>
+            static Scalar value(const Scalar &x) {
+                using std::exp;
+                return x / (Scalar(1) + exp(Scalar(-2) * z(x)));
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(const Scalar &x, const Scalar &y) {
+                using std::exp;
+                const Scalar s = Scalar(1) / (Scalar(1) + exp(Scalar(-2) * z(x)));
+                const Scalar dz = Scalar(0.7978845608028654) * (Scalar(1) + Scalar(3 * 0.044715) * x * x);
+                return s + Scalar(2) * y * (Scalar(1) - s) * dz;
+            }
+
+            template<typename Packet>
+            static Packet packet(const Packet &x) {
+                using namespace Eigen::internal;
+                using Scalar = typename unpacket_traits<Packet>::type;
+                const Packet x3 = pmul(pmul(x, x), x);
+                const Packet minus2z = pmul(pset1<Packet>(Scalar(-2 * 0.7978845608028654)),
+                                            padd(x, pmul(pset1<Packet>(Scalar(0.044715)), x3)));
+                return pdiv(x, padd(pset1<Packet>(Scalar(1)), pexp(minus2z)));
+            }
+
+        private:
+            template<typename Scalar>
+            static Scalar z(const Scalar &x) {
+                return Scalar(0.7978845608028654) * (x + Scalar(0.044715) * x * x * x);
+            }
+        };
+
+        /**
+         * @brief Sigmoid linear unit, also known as swish (https://arxiv.org/abs/1710.05941), y = x / (1 + exp(-x))
+         */
+        struct Silu {
+            template<typename Scalar>
+            static Scalar value(const Scalar &x) {
+                using std::exp;
+                return x / (Scalar(1) + exp(-x));
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(const Scalar &x, const Scalar &y) {
+                // With s = sigmoid(x) = y / x: dy/dx = s + x * s * (1 - s) = s + y * (1 - s)
+                using std::exp;
+                const Scalar s = Scalar(1) / (Scalar(1) + exp(-x));
+                return s + y * (Scalar(1) - s);
+            }
+
+            template<typename Packet>
+            static Packet packet(const Packet &x) {
+                using namespace Eigen::internal;
+                using Scalar = typename unpacket_traits<Packet>::type;
+                return pdiv(x, padd(pset1<Packet>(Scalar(1)), pexp(pnegate(x))));
+            }
+        };
+    }
+
+    namespace detail {
+        /**
+         * @brief Eigen functor applying an elementwise functor, vectorized using its packet op
+         * @tparam Functor The elementwise functor (see elementwise::LeakyRelu)
+         * @tparam Scalar The scalar type
+         */
+        template<typename Functor, typename Scalar>
+        struct ElementwiseOp {
+            Scalar operator()(const Scalar &x) const {
+                return Functor::value(x);
+            }
+
+            template<typename Packet>
+            Packet packetOp(const Packet &x) const {
+                return Functor::packet(x);
+            }
+        };
+
+        /**
+         * @brief The function of an Elementwise layer, which maps an Eigen array expression to an expression applying
+         *        the functor (see Activation.hpp), so Net can fuse it with adjacent elementwise layers
+         * @tparam Functor The elementwise functor
+         */
+        template<typename Functor>
+        struct ElementwiseFunction {
+            template<typename Expr>
+            static auto apply(const Expr &x) -> decltype(x.unaryExpr(ElementwiseOp<Functor, typename Expr::Scalar>())) {
+                return x.unaryExpr(ElementwiseOp<Functor, typename Expr::Scalar>());
+            }
+        };
+    }
+
+    /**
+     * @brief Activation layer applying an elementwise function given by a functor
+     * The layer provides the forward, in-place, inference and native backward passes of any activation, so adding an
+     * activation only takes a functor (see namespace elementwise). Plain values are computed using the packet op of
+     * the functor, and runs of elementwise layers are fused by Net.
+     * @tparam Dtype The scalar type to use for this layer
+     * @tparam InputSize The number of inputs to this layer
+     * @tparam BatchSize The batch size to use
+     * @tparam Functor The elementwise functor, which provides value(), derivative() and packet()
+     */
+    template <typename Dtype, int InputSize, int BatchSize, typename Functor>
+    class Elementwise {
+    public:
+        using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using OutputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using ValueInputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+        using ValueOutputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+
+        /// The elementwise function of this layer, which Net fuses with adjacent elementwise layers
+        using Function = detail::ElementwiseFunction<Functor>;
+
+        OutputTensor forward(const InputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Inference pass on plain values, which never records gradients
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Forward pass overwriting its input with its output, which Net uses when the input is a temporary that
+         *        is no longer needed, saving the output tensor and a pass over memory
+         * @param tensor [in, out]: The input to this layer, which is replaced by the output of this layer
+         */
+        void forwardInPlace(InputTensor &tensor) const {
+            apply(tensor, tensor);
+        }
+
+        /**
+         * @brief Inference pass on plain values overwriting its input with its output (see forwardInPlace())
+         * @param tensor [in, out]: The input to this layer, which is replaced by the output of this layer
+         */
+        void predictInPlace(ValueInputTensor &tensor) const {
+            apply(tensor, tensor);
+        }
+
+        /**
+         * @brief Backpropagate a gradient through this layer using the native backpropagation engine
+         * @param input The input given to forward()
+         * @param output The output returned by forward()
+         * @param gradOutput The gradient of the loss with respect to the output of this layer
+         * @return The gradient of the loss with respect to the input of this layer
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type backward(const InputTensor &input, const OutputTensor &output, const OutputTensor &gradOutput) const {
+            InputTensor gradInput;
+            for (int i = 0; i < BatchSize * InputSize; i++) {
+                gradInput.data()[i] = gradOutput.data()[i] * Functor::derivative(input.data()[i], output.data()[i]);
+            }
+            return gradInput;
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
+            // No weights to optimize
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type updateWeights(double /*gradientScale*/ = 1.0) {
+            // No weights to adjust here
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type mergeGradients(Elementwise &replica) {
+            // No gradients to merge
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type clearGradients() {
+            // No gradients to clear
+        }
+
+        void copyWeights(const Elementwise &source) {
+            // No weights to copy
+        }
+
+        void freeze(bool frozen = true) {
+            // No weights to freeze
+        }
+
+    private:
+        /**
+         * @brief Apply the activation function, shared by the auto diff/native forward() and the plain value predict()
+         * @tparam Scalar The scalar type of the tensor
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        template <typename Scalar>
+        static Tensor<Scalar, BatchSize, InputSize> apply(const Tensor<Scalar, BatchSize, InputSize> &input) {
+            Tensor<Scalar, BatchSize, InputSize> output;
+            apply(input, output);
+            return output;
+        }
+
+        /**
+         * @brief Apply the activation function into an output tensor, which may be the input tensor itself, as one
+         *        pass over the batch that is vectorized for plain values
+         * @tparam Scalar The scalar type of the tensor
+         * @param input The input to this layer
+         * @param output [out]: The output of this layer
+         */
+        template <typename Scalar>
+        static void apply(const Tensor<Scalar, BatchSize, InputSize> &input, Tensor<Scalar, BatchSize, InputSize> &output) {
+            TensorToDynamicMatrix<BatchSize, InputSize>(output).array() =
+                    Function::apply(ConstTensorToDynamicMatrix<BatchSize, InputSize>(input).array());
+        }
+    };
+
+    /**
+     * @brief Leaky rectified linear unit activation layer, y = max(x, 0.01x)
+     */
+    template <typename Dtype, int InputSize, int BatchSize>
+    using LeakyRelu = Elementwise<Dtype, InputSize, BatchSize, elementwise::LeakyRelu>;
+
+    /**
+     * @brief Exponential linear unit activation layer (https://arxiv.org/abs/1511.07289)
+     */
+    template <typename Dtype, int InputSize, int BatchSize>
+    using Elu = Elementwise<Dtype, InputSize, BatchSize, elementwise::Elu>;
+
+    /**
+     * @brief Gaussian error linear unit activation layer (https://arxiv.org/abs/1606.08415), tanh approximation
+     */
+    template <typename Dtype, int InputSize, int BatchSize>
+    using Gelu = Elementwise<Dtype, InputSize, BatchSize, elementwise::Gelu>;
+
+    /**
+     * @brief Sigmoid linear unit (swish) activation layer (https://arxiv.org/abs/1710.05941)
+     */
+    template <typename Dtype, int InputSize, int BatchSize>
+    using Silu = Elementwise<Dtype, InputSize, BatchSize, elementwise::Silu>;
+}
+
+namespace Eigen {
+    namespace internal {
+        /**
+         * @brief Let Eigen vectorize the functor of an Elementwise layer wherever exp is vectorized
+         */
+        template<typename Functor, typename Scalar>
+        struct functor_traits<neural::detail::ElementwiseOp<Functor, Scalar>> {
+            enum {
+                Cost = 10 * NumTraits<Scalar>::MulCost,
+                PacketAccess = packet_traits<Scalar>::HasExp
+            };
+        };
+    }
+}
+
+#endif //NEURAL_ELEMENTWISE_HPP
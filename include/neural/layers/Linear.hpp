@@ -11,9 +11,16 @@
 #ifndef NEURAL_LINEAR_HPP
 #define NEURAL_LINEAR_HPP
 
+#include <neural/util/Activation.hpp>
+#include <neural/util/Gemm.hpp>
 #include <neural/util/Gradient.hpp>
+#include <neural/util/LinearVari.hpp>
 #include <neural/util/Mapping.hpp>
+#include <neural/util/Storage.hpp>
 #include <neural/Tensor.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 #include <neural/initializers/GlorotNormal.hpp>
 #include <neural/optimizers/OptimizerFactory.hpp>
 
@@ -21,27 +28,40 @@ namespace neural {
     /**
      * @brief Layer for applying a linear operation, e.g. y = Ax + b, where x is the input, A is a set of learned
      *        weights, and b is a set of learned biases
+     * An activation function f can be fused into the layer, giving y = f(Ax + b). The bias and the activation are then
+     * applied by the matrix product kernels as they write the output, instead of by separate layers that each make a
+     * full pass over the output and return a new tensor. See LinearRelu, LinearSigmoid and LinearTanh
      * @tparam Dtype The scalar type to use for this layer
      * @tparam InputSize The number of inputs to this layer
      * @tparam NumNeurons The number of neurons (outputs)
      * @tparam BatchSize The batch size to use
      * @tparam UseBias Whether to include a bias term in this linear layer
+     * @tparam Activation The activation function to fuse into this layer (see Activation.hpp)
+     * @tparam Storage The storage policy of the frozen weights (see Storage.hpp). Training always updates weights at
+     *         full precision, and the weights are only stored at reduced precision once the layer is frozen. Freezing
+     *         at reduced precision releases the full precision weights and gradients, so the frozen layer only keeps
+     *         the reduced precision weights, and can only be used for inference until it is unfrozen
      */
-    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true>
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true,
+              typename Activation=activation::Identity, typename Storage=storage::Full>
     class Linear {
     public:
         using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
         using OutputTensor = Tensor<Dtype, BatchSize, NumNeurons>;
-        using WeightsTensor = Tensor<Dtype, InputSize, NumNeurons>;
-        using BiasesTensor = Tensor<Dtype, 1, NumNeurons>;
+        using WeightsTensor = Tensor<typename ValueType<Dtype>::type, InputSize, NumNeurons>;
+        using BiasesTensor = Tensor<typename ValueType<Dtype>::type, 1, NumNeurons>;
+        using ValueInputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+        using ValueOutputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, NumNeurons>;
         enum {
-            HasBias = UseBias
+            HasBias = UseBias,
+            ReducedPrecision = !std::is_same<typename Storage::template Type<typename ValueType<Dtype>::type>,
+                                             typename ValueType<Dtype>::type>::value     ///< Whether frozen weights are stored at reduced precision
         };
 
-        Linear(): m_optimizerAttached(false) {
+        Linear(): m_weights(new WeightsTensor()), m_optimizerAttached(false) {
             // Initialize weights with a GlorotNormal initialization
             // TODO: Support other initialization types through a template parameter
-            m_weights.template setRandom<GlorotNormal<Dtype, InputSize, NumNeurons>>();
+            m_weights->template setRandom<GlorotNormal<typename ValueType<Dtype>::type, InputSize, NumNeurons>>();
 
             if (HasBias) {
                 m_biases.setConstant(0);
@@ -49,64 +69,333 @@ namespace neural {
         }
 
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
-            m_weightsOptimizer = factory.createOptimizer(m_weights);
+        typename std::enable_if<IsTrainable<Q>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
+            m_weightsOptimizer = factory.createOptimizer(masterWeights());
             if (HasBias) {
                 m_biasOptimizer = factory.createOptimizer(m_biases);
             }
+            gradients();
             m_optimizerAttached = true;
         }
 
-        OutputTensor forward(const InputTensor &input) const {
-            // Create output
-            OutputTensor result;
+        template<class Q = Dtype>
+        typename std::enable_if<!std::is_same<Q, Derivative>::value, OutputTensor>::type forward(const InputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Auto diff forward pass, which records the whole layer as a single node on the tape. The weights and
+         *        biases are not recorded themselves - their gradients are accumulated directly into the gradient buffers
+         *        of this layer when the tape is propagated, so the layer must outlive the tape. The gradient buffers are
+         *        allocated by the first call if no optimizer has been attached, and no gradients are recorded for the
+         *        weights of a frozen layer
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<std::is_same<Q, Derivative>::value, OutputTensor>::type forward(const InputTensor &input) {
+            Gradients *gradient = frozen() ? nullptr : &gradients();
+            const auto *node = new detail::LinearVari<InputSize, NumNeurons, BatchSize, HasBias, Activation>(
+                    input.data(), masterWeights().data(), m_biases.data(),
+                    gradient ? gradient->weights.data() : nullptr, gradient ? gradient->biases.data() : nullptr);
 
-            // This is the standard Eigen::Tensor way of doing generalized matrix multiplication, but
-            // the auto diff libraries don't like this yet!
-            // static Eigen::array<Eigen::IndexPair<int>, 1> productDims = {Eigen::IndexPair<int>(1, 0)};
-            // const OutputTensor result = input.contract(m_weights, productDims);
+            OutputTensor result;
+            for (unsigned int i = 0; i < BatchSize * NumNeurons; i++) {
+                result.data()[i] = node->output(i);
+            }
+            return result;
+        }
 
-            // Instead, we apply the operations to each input in batch
-            const auto mappedWeights = ConstTensorToMatrix<InputSize, NumNeurons>(m_weights).transpose();
-            for (unsigned int i = 0; i < BatchSize; i++) {
-                // Map tensors to Eigen matrices
-                const auto mappedTensor = ConstTensorSliceToVector<InputSize, BatchSize>(input, i);
-                auto mappedOutput = TensorSliceToVector<NumNeurons, BatchSize>(result, i);
+        /**
+         * @brief Inference pass on plain values, which never records gradients. Auto diff layers evaluate their trained
+         *        weights directly, without recording a tape
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
 
-                // Perform y1 = Ax
-                mappedOutput.noalias() = mappedWeights * mappedTensor;
+        /**
+         * @brief Backpropagate a gradient through this layer using the native backpropagation engine. The gradients
+         *        with respect to the weights and biases are accumulated until the next call to updateWeights(), in
+         *        gradient buffers that are allocated by the first call if no optimizer has been attached. A layer frozen at
+         *        reduced precision can't be backpropagated through, as its full precision weights have been released
+         * @param input The input given to forward()
+         * @param output The output returned by forward()
+         * @param gradOutput The gradient of the loss with respect to the output of this layer
+         * @return The gradient of the loss with respect to the input of this layer
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type backward(const InputTensor &input, const OutputTensor &output, const OutputTensor &gradOutput) {
+            // Propagate through the fused activation, dz = dy * f'(y)
+            OutputTensor gradLinear;
+            for (unsigned int i = 0; i < BatchSize * NumNeurons; i++) {
+                gradLinear.data()[i] = gradOutput.data()[i] * Activation::derivative(output.data()[i]);
             }
 
-            if (!HasBias) {
-                return result;
+            const auto mappedInput = ConstTensorToDynamicMatrix<BatchSize, InputSize>(input);
+            const auto mappedGradOutput = ConstTensorToDynamicMatrix<BatchSize, NumNeurons>(gradLinear);
+
+            // Accumulate dW = x^T * dz and db = sum(dz) over the batch, unless the weights are frozen
+            if (!frozen()) {
+                Gradients &gradient = gradients();
+                TensorToDynamicMatrix<InputSize, NumNeurons>(gradient.weights).noalias() += mappedInput.transpose() * mappedGradOutput;
+                if (HasBias) {
+                    TensorToDynamicMatrix<1, NumNeurons>(gradient.biases).noalias() += mappedGradOutput.colwise().sum();
+                }
             }
 
-            // Apply bias to every element in batch by broadcasting the biases using replication
-            // y2 = y1 + b
-            static Eigen::array<Eigen::Index, 2> broadcastDims{BatchSize, 1};
-            return result + m_biases.broadcast(broadcastDims);
+            // Propagate dx = dz * W^T
+            InputTensor gradInput;
+            TensorToDynamicMatrix<BatchSize, InputSize>(gradInput).noalias() =
+                    mappedGradOutput * ConstTensorToDynamicMatrix<InputSize, NumNeurons>(masterWeights()).transpose();
+            return gradInput;
         }
 
+        /**
+         * @brief Adjust the weights and biases using the gradients accumulated since the last update, and reset them
+         * @param gradientScale Factor applied to the accumulated gradients first, e.g. 1/N after accumulating N batches
+         */
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type updateWeights() {
+        typename std::enable_if<IsTrainable<Q>::value, void>::type updateWeights(double gradientScale = 1.0) {
             if (!m_optimizerAttached) {
                 throw std::runtime_error("No optimizer attached - cannot update weights");
             }
 
-            // Backprop is available, adjust weights and biases
-            m_weights -= m_weightsOptimizer->update(m_weights);
+            // Frozen weights are never updated, so any gradients recorded for them are simply discarded
+            if (frozen()) {
+                clearGradients();
+                return;
+            }
+
+            Gradients &gradient = gradients();
+            if (gradientScale != 1.0) {
+                TensorToDynamicMatrix<InputSize, NumNeurons>(gradient.weights) *= gradientScale;
+                TensorToDynamicMatrix<1, NumNeurons>(gradient.biases) *= gradientScale;
+            }
+
+            // Gradients have been accumulated by the backward pass, adjust weights and biases in place
+            m_weightsOptimizer->update(*m_weights, gradient.weights);
+            gradient.weights.setZero();
             if (HasBias) {
-                m_biases -= m_biasOptimizer->update(m_biases);
+                m_biasOptimizer->update(m_biases, gradient.biases);
+                gradient.biases.setZero();
             }
         }
 
+        /**
+         * @brief Add the accumulated gradients of a replica of this layer to the gradients of this layer, and reset the
+         *        gradients of the replica
+         * @param replica The replica to merge gradients from
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type mergeGradients(Linear &replica) {
+            // A replica that never computed any gradients has nothing to merge
+            if (!replica.m_gradients) {
+                return;
+            }
+            Gradients &gradient = gradients();
+            TensorToDynamicMatrix<InputSize, NumNeurons>(gradient.weights) += ConstTensorToDynamicMatrix<InputSize, NumNeurons>(replica.m_gradients->weights);
+            replica.m_gradients->weights.setZero();
+            if (HasBias) {
+                TensorToDynamicMatrix<1, NumNeurons>(gradient.biases) += ConstTensorToDynamicMatrix<1, NumNeurons>(replica.m_gradients->biases);
+                replica.m_gradients->biases.setZero();
+            }
+        }
+
+        /**
+         * @brief Discard the gradients accumulated since the last update without updating the weights
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type clearGradients() {
+            if (m_gradients) {
+                m_gradients->weights.setZero();
+                m_gradients->biases.setZero();
+            }
+        }
+
+        /**
+         * @brief Copy the weights and biases of another layer of the same type, e.g. a layer trained at full precision
+         *        into a layer storing its frozen weights at reduced precision
+         * @tparam SourceStorage The storage policy of the layer to copy from
+         * @param source The layer to copy from
+         */
+        template<typename SourceStorage>
+        void copyWeights(const Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, SourceStorage> &source) {
+            const WeightsTensor &weights = source.weights();
+            if (m_weights) {
+                *m_weights = weights;
+            }
+            m_biases = source.biases();
+            if (frozen()) {
+                packRhs<BatchSize, InputSize, NumNeurons>(weights.data(), m_packedWeights.data());
+            }
+        }
+
+        /**
+         * @brief Freeze or unfreeze the weights and biases of this layer, e.g. once training has finished or weights
+         *        have been loaded. Freezing repacks the weights once into the layout consumed by the matrix product
+         *        kernels, so forward() and predict() no longer pack or stride through them on every call. Gradients are
+         *        still propagated to the input of a frozen layer, but its own weights are not updated, so its gradient
+         *        buffers are released. The packed weights are stored as selected by the Storage policy. At full
+         *        precision, the original weights are kept as well. At reduced precision, they are released, and are
+         *        widened back from the stored weights when the layer is unfrozen
+         * @param frozen Whether to freeze the weights
+         */
+        void freeze(bool frozen = true) {
+            if (frozen) {
+                if (!m_weights) {
+                    // Already frozen at reduced precision
+                    return;
+                }
+                m_packedWeights.resize(InputSize * NumNeurons);
+                packRhs<BatchSize, InputSize, NumNeurons>(m_weights->data(), m_packedWeights.data());
+                m_gradients.reset();
+                if (ReducedPrecision) {
+                    m_weights.reset();
+                }
+            } else {
+                if (!m_weights) {
+                    m_weights.reset(new WeightsTensor());
+                    widenPackedWeights(*m_weights);
+                }
+                m_packedWeights.clear();
+                m_packedWeights.shrink_to_fit();
+            }
+        }
+
+        /**
+         * @brief Get the weights of this layer, which must be unfrozen first if it was frozen at reduced precision
+         * @return The InputSize x NumNeurons weights
+         */
+        const WeightsTensor& weights() const {
+            return masterWeights();
+        }
+
+        /**
+         * @brief Get the biases of this layer
+         * @return The 1 x NumNeurons biases
+         */
+        const BiasesTensor& biases() const {
+            return m_biases;
+        }
+
+        /**
+         * @brief Check whether the weights of this layer are frozen
+         * @return Whether the weights are frozen
+         */
+        bool frozen() const {
+            return !m_packedWeights.empty();
+        }
+
     private:
-        WeightsTensor m_weights;    ///< The weights of this linear layer
+        /**
+         * @brief The gradients of the loss with respect to the weights and biases, stored apart from the weights and
+         *        biases themselves
+         */
+        struct Gradients {
+            WeightsTensor weights;  ///< The gradient of the loss with respect to the weights
+            BiasesTensor biases;    ///< The gradient of the loss with respect to the biases
+        };
+
+        /**
+         * @brief Get the gradient buffers of this layer, allocating them on first use. Layers that are only used for
+         *        inference, or that are frozen, never allocate them
+         * @return The gradient buffers
+         */
+        Gradients& gradients() {
+            if (!m_gradients) {
+                m_gradients.reset(new Gradients());
+                m_gradients->weights.setZero();
+                m_gradients->biases.setZero();
+            }
+            return *m_gradients;
+        }
+
+        /**
+         * @brief Get the full precision weights, which are only released while the layer is frozen at reduced precision
+         * @return The InputSize x NumNeurons weights
+         */
+        const WeightsTensor& masterWeights() const {
+            if (!m_weights) {
+                throw std::runtime_error("Weights frozen at reduced precision are not available - unfreeze the layer first");
+            }
+            return *m_weights;
+        }
+
+        /**
+         * @brief Widen the frozen weights back to full precision. The packed weights are multiplied by rows of the
+         *        identity using the same kernels as apply(), which reproduces them exactly whatever their packed layout
+         * @param weights [out]: The InputSize x NumNeurons weights
+         */
+        void widenPackedWeights(WeightsTensor &weights) const {
+            ValueInputTensor identity;
+            ValueOutputTensor rows;
+            for (unsigned int first = 0; first < InputSize; first += BatchSize) {
+                const unsigned int numRows = InputSize - first < BatchSize ? InputSize - first : BatchSize;
+                identity.setZero();
+                for (unsigned int i = 0; i < numRows; i++) {
+                    identity(i, first + i) = 1;
+                }
+                matrixProductPacked<BatchSize, InputSize, NumNeurons>(identity.data(), m_packedWeights.data(), rows.data());
+                for (unsigned int j = 0; j < NumNeurons; j++) {
+                    for (unsigned int i = 0; i < numRows; i++) {
+                        weights(first + i, j) = rows(i, j);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Perform y = f(xW + b) on plain values, shared by the inference/native forward() and predict()
+         * The whole batch is computed as a single matrix-matrix product, so the weights are streamed through the cache
+         * once per batch instead of once per sample. The product uses microkernels specialized on the layer sizes
+         * where they pay off, and Eigen's blocked GEMM otherwise (see Gemm.hpp). The microkernels add the bias and
+         * apply the activation to every tile of the output while it is still in registers
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor apply(const ValueInputTensor &input) const {
+            ValueOutputTensor result;
+            const Epilogue<typename ValueType<Dtype>::type, Activation> epilogue{HasBias ? m_biases.data() : nullptr};
+            if (frozen()) {
+                matrixProductPacked<BatchSize, InputSize, NumNeurons>(input.data(), m_packedWeights.data(), result.data(), epilogue);
+            } else {
+                matrixProduct<BatchSize, InputSize, NumNeurons>(input.data(), m_weights->data(), result.data(), epilogue);
+            }
+            return result;
+        }
+
+        std::unique_ptr<WeightsTensor> m_weights;   ///< The full precision weights of this linear layer (null while frozen at reduced precision)
         std::unique_ptr<Optimizer<WeightsTensor>> m_weightsOptimizer;   ///< Pointer to an optimizer used for updating the weights
         BiasesTensor m_biases;      ///< The biases of this linear layer
         std::unique_ptr<Optimizer<BiasesTensor>> m_biasOptimizer;       ///< Pointer to an optimizer used for updating the biases
+        std::unique_ptr<Gradients> m_gradients;     ///< The gradient buffers, allocated once gradients are needed (see gradients())
         bool m_optimizerAttached;   ///< Whether an optimizer has been attached to this layer
+        std::vector<typename Storage::template Type<typename ValueType<Dtype>::type>> m_packedWeights;  ///< The frozen weights in the layout of the matrix product kernels (empty if not frozen)
     };
+
+    /**
+     * @brief Linear layer with a fused rectified linear unit activation, y = max(Ax + b, 0)
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true,
+              typename Storage=storage::Full>
+    using LinearRelu = Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, activation::Relu, Storage>;
+
+    /**
+     * @brief Linear layer with a fused sigmoid activation, y = 1 / (1 + exp(-(Ax + b)))
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true,
+              typename Storage=storage::Full>
+    using LinearSigmoid = Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, activation::Sigmoid, Storage>;
+
+    /**
+     * @brief Linear layer with a fused hyperbolic tangent activation, y = tanh(Ax + b)
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true,
+              typename Storage=storage::Full>
+    using LinearTanh = Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, activation::Tanh, Storage>;
 }
 
 #endif //NEURAL_LINEAR_HPP
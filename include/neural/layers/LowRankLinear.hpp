@@ -0,0 +1,175 @@
+/**
+* \file LowRankLinear.hpp
+*
+* \brief Inference-only linear layer, y = f(xUV + b), with the weights of a trained Linear layer factorized to low rank
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_LOWRANKLINEAR_HPP
+#define NEURAL_LOWRANKLINEAR_HPP
+
+#include <type_traits>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/SVD>
+#include <neural/layers/Linear.hpp>
+#include <neural/util/Activation.hpp>
+#include <neural/util/Gemm.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Mapping.hpp>
+#include <neural/Tensor.hpp>
+
+namespace neural {
+    /**
+     * @brief Inference-only linear layer, y = f(xUV + b), with the weights of a trained Linear layer factorized to low
+     *        rank
+     * The InputSize x NumNeurons weights W are replaced by their truncated singular value decomposition, W ~ UV, where
+     * U is InputSize x Rank and V is Rank x NumNeurons, which is the best rank Rank approximation of W. Every forward
+     * pass computes two thin matrix products instead of one wide one, which cuts the multiply-adds and the weights per
+     * sample from InputSize * NumNeurons to (InputSize + NumNeurons) * Rank
+     * @tparam Dtype The scalar type of the input and output, which must be float or double
+     * @tparam InputSize The number of inputs to this layer
+     * @tparam NumNeurons The number of neurons (outputs)
+     * @tparam Rank The rank of the factorized weights
+     * @tparam BatchSize The batch size to use
+     * @tparam UseBias Whether to include a bias term in this linear layer
+     * @tparam Activation The activation function to fuse into this layer (see Activation.hpp)
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int Rank, unsigned int BatchSize,
+              bool UseBias=true, typename Activation=activation::Identity>
+    class LowRankLinear {
+        static_assert(IsNative<Dtype>::value, "LowRankLinear requires a native (float/double) scalar type");
+        static_assert(Rank > 0 && Rank <= InputSize && Rank <= NumNeurons, "The rank must be in [1, min(InputSize, NumNeurons)]");
+
+    public:
+        using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using OutputTensor = Tensor<Dtype, BatchSize, NumNeurons>;
+        using WeightsTensor = Tensor<Dtype, InputSize, NumNeurons>;
+        using BiasesTensor = Tensor<Dtype, 1, NumNeurons>;
+        using ValueInputTensor = InputTensor;
+        using ValueOutputTensor = OutputTensor;
+        enum { HasBias = UseBias };
+
+        /**
+         * @brief Factorize the weights of a trained Linear layer using a truncated singular value decomposition
+         * @tparam SourceDtype The scalar type of the Linear layer, whose value type must be Dtype
+         * @tparam Storage The storage policy of the Linear layer, which does not affect the factorization
+         * @param source The Linear layer to factorize
+         */
+        template <typename SourceDtype, typename Storage>
+        explicit LowRankLinear(const Linear<SourceDtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, Storage> &source):
+                m_packedU(InputSize * Rank), m_packedV(Rank * NumNeurons) {
+            static_assert(std::is_same<typename ValueType<SourceDtype>::type, Dtype>::value,
+                          "LowRankLinear must use the value type of the Linear layer it is converted from");
+            using Matrix = Eigen::Matrix<Dtype, Eigen::Dynamic, Eigen::Dynamic>;
+            const Eigen::BDCSVD<Matrix> svd(ConstTensorToDynamicMatrix<InputSize, NumNeurons>(source.weights()),
+                                            Eigen::ComputeThinU | Eigen::ComputeThinV);
+
+            // Split every singular value evenly between the factors, so U and V have comparable magnitudes
+            const auto roots = svd.singularValues().head(Rank).cwiseSqrt().asDiagonal();
+            TensorToDynamicMatrix<InputSize, Rank>(m_u) = svd.matrixU().leftCols(Rank) * roots;
+            TensorToDynamicMatrix<Rank, NumNeurons>(m_v) = roots * svd.matrixV().leftCols(Rank).transpose();
+            pack();
+
+            if (HasBias) {
+                m_biases = source.biases();
+            } else {
+                m_biases.setZero();
+            }
+        }
+
+        OutputTensor forward(const InputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Inference pass on plain values
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Copy the factorized weights and biases of another layer of the same type
+         * @param source The layer to copy from
+         */
+        void copyWeights(const LowRankLinear &source) {
+            m_u = source.m_u;
+            m_v = source.m_v;
+            m_biases = source.m_biases;
+            pack();
+        }
+
+        void freeze(bool frozen = true) {
+            // Factorized weights are always frozen
+        }
+
+        /**
+         * @brief Get the weights approximated by the factors of this layer, UV
+         * @return The InputSize x NumNeurons weights
+         */
+        WeightsTensor weights() const {
+            WeightsTensor result;
+            TensorToDynamicMatrix<InputSize, NumNeurons>(result).noalias() =
+                    ConstTensorToDynamicMatrix<InputSize, Rank>(m_u) * ConstTensorToDynamicMatrix<Rank, NumNeurons>(m_v);
+            return result;
+        }
+
+        /**
+         * @brief Get the number of bytes used for storing the factorized weights
+         * @return The number of bytes
+         */
+        static constexpr unsigned int weightsBytes() {
+            return (InputSize + NumNeurons) * Rank * sizeof(Dtype);
+        }
+
+    private:
+        /**
+         * @brief Pack the factors once into the layout consumed by the matrix product kernels
+         */
+        void pack() {
+            packRhs<BatchSize, InputSize, Rank>(m_u.data(), m_packedU.data());
+            packRhs<BatchSize, Rank, NumNeurons>(m_v.data(), m_packedV.data());
+        }
+
+        /**
+         * @brief Perform y = f(xUV + b) as two thin matrix products. The bias and activation are applied by the second
+         *        product to every tile of the output while it is still in registers
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        OutputTensor apply(const InputTensor &input) const {
+            Tensor<Dtype, BatchSize, Rank> projected;
+            matrixProductPacked<BatchSize, InputSize, Rank>(input.data(), m_packedU.data(), projected.data());
+            OutputTensor result;
+            matrixProductPacked<BatchSize, Rank, NumNeurons>(projected.data(), m_packedV.data(), result.data(),
+                    Epilogue<Dtype, Activation>{HasBias ? m_biases.data() : nullptr});
+            return result;
+        }
+
+        Tensor<Dtype, InputSize, Rank> m_u;     ///< The InputSize x Rank factor U
+        Tensor<Dtype, Rank, NumNeurons> m_v;    ///< The Rank x NumNeurons factor V
+        std::vector<Dtype> m_packedU;           ///< The factor U in the layout of the matrix product kernels
+        std::vector<Dtype> m_packedV;           ///< The factor V in the layout of the matrix product kernels
+        BiasesTensor m_biases;                  ///< The biases of this linear layer, which are not factorized
+    };
+
+    /**
+     * @brief Helper function to factorize a trained Linear layer with automatic template deduction
+     * @tparam Rank The rank of the factorized weights
+     * @param linear The Linear layer to factorize
+     * @return The LowRankLinear layer
+     */
+    template <unsigned int Rank, typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize,
+              bool UseBias, typename Activation, typename Storage>
+    LowRankLinear<typename ValueType<Dtype>::type, InputSize, NumNeurons, Rank, BatchSize, UseBias, Activation>
+    factorize(const Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, Storage> &linear) {
+        return LowRankLinear<typename ValueType<Dtype>::type, InputSize, NumNeurons, Rank, BatchSize, UseBias, Activation>(linear);
+    }
+}
+
+#endif //NEURAL_LOWRANKLINEAR_HPP
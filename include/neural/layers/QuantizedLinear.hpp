@@ -0,0 +1,168 @@
+/**
+* \file QuantizedLinear.hpp
+*
+* \brief Inference-only linear layer, y = f(Ax + b), with int8 weights and dynamically quantized int8 activations
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_QUANTIZEDLINEAR_HPP
+#define NEURAL_QUANTIZEDLINEAR_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <neural/layers/Linear.hpp>
+#include <neural/util/Activation.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Mapping.hpp>
+#include <neural/util/Quantization.hpp>
+#include <neural/Tensor.hpp>
+
+namespace neural {
+    /**
+     * @brief Inference-only linear layer, y = f(Ax + b), with int8 weights and dynamically quantized int8 activations
+     * The weights of a trained Linear layer are quantized symmetrically with one scale per neuron, which stores them in
+     * a quarter of the memory of float weights (an eighth of double weights). Every forward pass quantizes each sample
+     * of the input with its own scale, computes the product in int32 using int8 kernels (see Quantization.hpp), and
+     * rescales the result to Dtype before applying the bias and the fused activation
+     * @tparam Dtype The scalar type of the input and output, which must be float or double
+     * @tparam InputSize The number of inputs to this layer
+     * @tparam NumNeurons The number of neurons (outputs)
+     * @tparam BatchSize The batch size to use
+     * @tparam UseBias Whether to include a bias term in this linear layer
+     * @tparam Activation The activation function to fuse into this layer (see Activation.hpp)
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true,
+              typename Activation=activation::Identity>
+    class QuantizedLinear {
+        static_assert(IsNative<Dtype>::value, "QuantizedLinear requires a native (float/double) scalar type");
+
+    public:
+        using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using OutputTensor = Tensor<Dtype, BatchSize, NumNeurons>;
+        using BiasesTensor = Tensor<Dtype, 1, NumNeurons>;
+        using ValueInputTensor = InputTensor;
+        using ValueOutputTensor = OutputTensor;
+        enum {
+            HasBias = UseBias,
+            PaddedInputSize = int8PaddedDepth(InputSize)    ///< The number of inputs padded for the int8 kernels
+        };
+
+        /**
+         * @brief Quantize the weights of a trained Linear layer
+         * @tparam SourceDtype The scalar type of the Linear layer, whose value type must be Dtype
+         * @tparam Storage The storage policy of the Linear layer, which does not affect quantization
+         * @param source The Linear layer to quantize
+         */
+        template <typename SourceDtype, typename Storage>
+        explicit QuantizedLinear(const Linear<SourceDtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, Storage> &source) {
+            static_assert(std::is_same<typename ValueType<SourceDtype>::type, Dtype>::value,
+                          "QuantizedLinear must use the value type of the Linear layer it is converted from");
+
+            // Every neuron is a contiguous column of the weights, which is quantized with its own scale
+            const auto &weights = source.weights();
+            m_weights.fill(0);
+            for (unsigned int j = 0; j < NumNeurons; j++) {
+                std::int8_t *neuronWeights = m_weights.data() + j * PaddedInputSize;
+                m_scales[j] = quantizeSymmetric(weights.data() + j * InputSize, InputSize, neuronWeights);
+
+                // The activations are offset by 128, which is subtracted again from the products using these sums
+                std::int32_t sum = 0;
+                for (unsigned int k = 0; k < InputSize; k++) {
+                    sum += neuronWeights[k];
+                }
+                m_offsets[j] = 128 * sum;
+            }
+            if (HasBias) {
+                m_biases = source.biases();
+            } else {
+                m_biases.setZero();
+            }
+        }
+
+        OutputTensor forward(const InputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Inference pass on plain values
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Copy the quantized weights and biases of another layer of the same type
+         * @param source The layer to copy from
+         */
+        void copyWeights(const QuantizedLinear &source) {
+            m_weights = source.m_weights;
+            m_scales = source.m_scales;
+            m_offsets = source.m_offsets;
+            m_biases = source.m_biases;
+        }
+
+        void freeze(bool frozen = true) {
+            // Quantized weights are always frozen
+        }
+
+        /**
+         * @brief Get the number of bytes used for storing the quantized weights
+         * @return The number of bytes
+         */
+        static constexpr unsigned int weightsBytes() {
+            return NumNeurons * PaddedInputSize * sizeof(std::int8_t) + NumNeurons * sizeof(Dtype);
+        }
+
+    private:
+        /**
+         * @brief Perform y = f(xW + b) using int8 weights and activations
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        OutputTensor apply(const InputTensor &input) const {
+            // Quantize every sample with its own scale, in the grouped layout used by the kernels
+            std::array<std::uint32_t, BatchSize * PaddedInputSize / 4> activations;
+            std::array<Dtype, BatchSize> activationScales;
+            quantizeActivations<BatchSize, InputSize>(input.data(), activationScales.data(), activations.data());
+
+            std::array<std::int32_t, BatchSize * NumNeurons> products;
+            int8Gemm<BatchSize, PaddedInputSize, NumNeurons>(activations.data(), m_weights.data(), products.data());
+
+            // Epilogue: rescale, then apply bias and activation to every column in a single pass while writing back
+            OutputTensor result;
+            auto mappedOutput = TensorToDynamicMatrix<BatchSize, NumNeurons>(result);
+            for (unsigned int j = 0; j < NumNeurons; j++) {
+                for (unsigned int i = 0; i < BatchSize; i++) {
+                    mappedOutput(i, j) = Dtype(products[i + j * BatchSize] - m_offsets[j]) * activationScales[i] * m_scales[j];
+                }
+                auto column = mappedOutput.col(j).array();
+                column = Activation::apply(column + (HasBias ? m_biases(0, j) : Dtype(0)));
+            }
+            return result;
+        }
+
+        std::array<std::int8_t, NumNeurons * PaddedInputSize> m_weights;  ///< The quantized weights, one padded row per neuron
+        std::array<Dtype, NumNeurons> m_scales;         ///< The scale of the quantized weights of every neuron
+        std::array<std::int32_t, NumNeurons> m_offsets; ///< 128 times the sum of the quantized weights of every neuron
+        BiasesTensor m_biases;                          ///< The biases of this linear layer, which are not quantized
+    };
+
+    /**
+     * @brief Helper function to quantize a trained Linear layer with automatic template deduction
+     * @param linear The Linear layer to quantize
+     * @return The QuantizedLinear layer
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias, typename Activation,
+              typename Storage>
+    QuantizedLinear<typename ValueType<Dtype>::type, InputSize, NumNeurons, BatchSize, UseBias, Activation>
+    quantize(const Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, Storage> &linear) {
+        return QuantizedLinear<typename ValueType<Dtype>::type, InputSize, NumNeurons, BatchSize, UseBias, Activation>(linear);
+    }
+}
+
+#endif //NEURAL_QUANTIZEDLINEAR_HPP
@@ -10,6 +10,7 @@
 #ifndef NEURAL_RELU_HPP
 #define NEURAL_RELU_HPP
 
+#include <neural/util/Activation.hpp>
 #include <neural/util/Gradient.hpp>
 #include <neural/Tensor.hpp>
 #include <neural/optimizers/OptimizerFactory.hpp>
@@ -26,20 +27,108 @@ namespace neural {
     public:
         using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
         using OutputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using ValueInputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+        using ValueOutputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+
+        /// The elementwise function of this layer, which Net fuses with the functions of adjacent elementwise layers
+        using Function = activation::Relu;
 
         OutputTensor forward(const InputTensor &input) const {
-            return input.cwiseMax(Dtype(0));
+            return apply(input);
+        }
+
+        /**
+         * @brief Inference pass on plain values, which never records gradients
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Forward pass overwriting its input with its output, which Net uses when the input is a temporary that
+         *        is no longer needed, saving the output tensor and a pass over memory
+         * @param tensor [in, out]: The input to this layer, which is replaced by the output of this layer
+         */
+        void forwardInPlace(InputTensor &tensor) const {
+            apply(tensor, tensor);
+        }
+
+        /**
+         * @brief Inference pass on plain values overwriting its input with its output (see forwardInPlace())
+         * @param tensor [in, out]: The input to this layer, which is replaced by the output of this layer
+         */
+        void predictInPlace(ValueInputTensor &tensor) const {
+            apply(tensor, tensor);
+        }
+
+        /**
+         * @brief Backpropagate a gradient through this layer using the native backpropagation engine
+         * @param input The input given to forward()
+         * @param output The output returned by forward()
+         * @param gradOutput The gradient of the loss with respect to the output of this layer
+         * @return The gradient of the loss with respect to the input of this layer
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type backward(const InputTensor &input, const OutputTensor &output, const OutputTensor &gradOutput) const {
+            // The derivative is 1 where the unit is active and 0 elsewhere
+            return gradOutput * (output > Dtype(0)).template cast<Dtype>();
         }
 
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
+        typename std::enable_if<IsTrainable<Q>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
             // No weights to optimize
         }
 
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type updateWeights() {
+        typename std::enable_if<IsTrainable<Q>::value, void>::type updateWeights(double /*gradientScale*/ = 1.0) {
             // No weights to adjust here
         }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type mergeGradients(Relu &replica) {
+            // No gradients to merge
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type clearGradients() {
+            // No gradients to clear
+        }
+
+        void copyWeights(const Relu &source) {
+            // No weights to copy
+        }
+
+        void freeze(bool frozen = true) {
+            // No weights to freeze
+        }
+
+    private:
+        /**
+         * @brief Apply the activation function, shared by the auto diff/native forward() and the plain value predict()
+         * @tparam Scalar The scalar type of the tensor
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        template <typename Scalar>
+        static Tensor<Scalar, BatchSize, InputSize> apply(const Tensor<Scalar, BatchSize, InputSize> &input) {
+            Tensor<Scalar, BatchSize, InputSize> output;
+            apply(input, output);
+            return output;
+        }
+
+        /**
+         * @brief Apply the activation function into an output tensor, which may be the input tensor itself
+         * @tparam Scalar The scalar type of the tensor
+         * @param input The input to this layer
+         * @param output [out]: The output of this layer
+         */
+        template <typename Scalar>
+        static void apply(const Tensor<Scalar, BatchSize, InputSize> &input, Tensor<Scalar, BatchSize, InputSize> &output) {
+            typename Tensor<Scalar, BatchSize, InputSize>::EigenType &result = output;
+            result = input.cwiseMax(Scalar(0));
+        }
     };
 }
 
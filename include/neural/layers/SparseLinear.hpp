@@ -0,0 +1,156 @@
+/**
+* \file SparseLinear.hpp
+*
+* \brief Inference-only linear layer, y = f(Ax + b), with block-sparse weights pruned from a trained Linear layer
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_SPARSELINEAR_HPP
+#define NEURAL_SPARSELINEAR_HPP
+
+#include <type_traits>
+#include <neural/layers/Linear.hpp>
+#include <neural/util/Activation.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/SparseGemm.hpp>
+#include <neural/Tensor.hpp>
+
+namespace neural {
+    /**
+     * @brief Inference-only linear layer, y = f(Ax + b), with block-sparse weights pruned from a trained Linear layer
+     * The weights are split into blocks of BlockInputs inputs x BlockNeurons neurons, and only the blocks with the
+     * largest L2 norms are kept (see pruneBlocks()). Every forward pass multiplies only the kept blocks using SIMD
+     * kernels (see blockSparseGemm()), so the work and the memory traffic of the weights scale with the density
+     * @tparam Dtype The scalar type of the input and output, which must be float or double
+     * @tparam InputSize The number of inputs to this layer, which must be a multiple of BlockInputs
+     * @tparam NumNeurons The number of neurons (outputs)
+     * @tparam BatchSize The batch size to use
+     * @tparam UseBias Whether to include a bias term in this linear layer
+     * @tparam Activation The activation function to fuse into this layer (see Activation.hpp)
+     * @tparam BlockInputs The number of inputs of a block of weights
+     * @tparam BlockNeurons The number of neurons of a block of weights
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias=true,
+              typename Activation=activation::Identity, unsigned int BlockInputs=1, unsigned int BlockNeurons=8>
+    class SparseLinear {
+        static_assert(IsNative<Dtype>::value, "SparseLinear requires a native (float/double) scalar type");
+
+    public:
+        using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using OutputTensor = Tensor<Dtype, BatchSize, NumNeurons>;
+        using WeightsTensor = Tensor<Dtype, InputSize, NumNeurons>;
+        using BiasesTensor = Tensor<Dtype, 1, NumNeurons>;
+        using ValueInputTensor = InputTensor;
+        using ValueOutputTensor = OutputTensor;
+        enum { HasBias = UseBias };
+
+        /**
+         * @brief Prune the weights of a trained Linear layer
+         * @tparam SourceDtype The scalar type of the Linear layer, whose value type must be Dtype
+         * @tparam Storage The storage policy of the Linear layer, which does not affect pruning
+         * @param source The Linear layer to prune
+         * @param sparsity The fraction of blocks of weights to prune, in [0, 1]
+         */
+        template <typename SourceDtype, typename Storage>
+        SparseLinear(const Linear<SourceDtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, Storage> &source,
+                     double sparsity) {
+            static_assert(std::is_same<typename ValueType<SourceDtype>::type, Dtype>::value,
+                          "SparseLinear must use the value type of the Linear layer it is converted from");
+            pruneBlocks<InputSize, NumNeurons>(source.weights().data(), sparsity, m_weights);
+            if (HasBias) {
+                m_biases = source.biases();
+            } else {
+                m_biases.setZero();
+            }
+        }
+
+        OutputTensor forward(const InputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Inference pass on plain values
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Copy the pruned weights and biases of another layer of the same type
+         * @param source The layer to copy from
+         */
+        void copyWeights(const SparseLinear &source) {
+            m_weights = source.m_weights;
+            m_biases = source.m_biases;
+        }
+
+        void freeze(bool frozen = true) {
+            // Pruned weights are always frozen
+        }
+
+        /**
+         * @brief Get the pruned weights of this layer, with zeros for the pruned blocks
+         * @return The InputSize x NumNeurons weights
+         */
+        WeightsTensor weights() const {
+            WeightsTensor result;
+            densify<InputSize, NumNeurons>(m_weights, result.data());
+            return result;
+        }
+
+        /**
+         * @brief Get the fraction of blocks of weights that are kept
+         * @return The density, in [0, 1]
+         */
+        double density() const {
+            return double(m_weights.blocks()) / double(m_weights.columnStarts.size() - 1) / double(InputSize / BlockInputs);
+        }
+
+        /**
+         * @brief Get the number of bytes used for storing the pruned weights
+         * @return The number of bytes
+         */
+        unsigned int weightsBytes() const {
+            return m_weights.values.size() * sizeof(Dtype) + (m_weights.blockRows.size() + m_weights.columnStarts.size()) * sizeof(unsigned int);
+        }
+
+    private:
+        /**
+         * @brief Perform y = f(xW + b) using the kept blocks of the weights. The kernels add the bias and apply the
+         *        activation to every tile of the output while it is still in registers
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        OutputTensor apply(const InputTensor &input) const {
+            OutputTensor result;
+            blockSparseGemm<BatchSize, InputSize, NumNeurons>(input.data(), m_weights, result.data(),
+                    Epilogue<Dtype, Activation>{HasBias ? m_biases.data() : nullptr});
+            return result;
+        }
+
+        BlockSparseMatrix<Dtype, BlockInputs, BlockNeurons> m_weights;  ///< The kept blocks of the weights
+        BiasesTensor m_biases;      ///< The biases of this linear layer, which are not pruned
+    };
+
+    /**
+     * @brief Helper function to prune a trained Linear layer with automatic template deduction
+     * @tparam BlockInputs The number of inputs of a block of weights
+     * @tparam BlockNeurons The number of neurons of a block of weights
+     * @param linear The Linear layer to prune
+     * @param sparsity The fraction of blocks of weights to prune, in [0, 1]
+     * @return The SparseLinear layer
+     */
+    template <unsigned int BlockInputs=1, unsigned int BlockNeurons=8, typename Dtype, unsigned int InputSize,
+              unsigned int NumNeurons, unsigned int BatchSize, bool UseBias, typename Activation, typename Storage>
+    SparseLinear<typename ValueType<Dtype>::type, InputSize, NumNeurons, BatchSize, UseBias, Activation, BlockInputs, BlockNeurons>
+    prune(const Linear<Dtype, InputSize, NumNeurons, BatchSize, UseBias, Activation, Storage> &linear, double sparsity) {
+        return SparseLinear<typename ValueType<Dtype>::type, InputSize, NumNeurons, BatchSize, UseBias, Activation,
+                            BlockInputs, BlockNeurons>(linear, sparsity);
+    }
+}
+
+#endif //NEURAL_SPARSELINEAR_HPP
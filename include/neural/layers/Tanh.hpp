@@ -10,7 +10,11 @@
 #ifndef NEURAL_TANH_HPP
 #define NEURAL_TANH_HPP
 
+#include <type_traits>
+#include <neural/util/Activation.hpp>
+#include <neural/util/FastMath.hpp>
 #include <neural/util/Gradient.hpp>
+#include <neural/util/Mapping.hpp>
 #include <neural/Tensor.hpp>
 #include <neural/optimizers/OptimizerFactory.hpp>
 
@@ -20,26 +24,142 @@ namespace neural {
      * @tparam Dtype The scalar type to use for this layer
      * @tparam InputSize The number of inputs to this layer
      * @tparam BatchSize The batch size to use
+     * @tparam Accuracy The accuracy policy of the activation function of plain values (see FastMath.hpp)
      */
-    template <typename Dtype, int InputSize, int BatchSize>
+    template <typename Dtype, int InputSize, int BatchSize, typename Accuracy = accuracy::Exact>
     class Tanh {
     public:
         using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
         using OutputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using ValueInputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+        using ValueOutputTensor = Tensor<typename ValueType<Dtype>::type, BatchSize, InputSize>;
+
+        /// The elementwise function of this layer, which Net fuses with adjacent elementwise layers (void if approximated)
+        using Function = typename std::conditional<std::is_same<Accuracy, accuracy::Exact>::value, activation::Tanh, void>::type;
 
         OutputTensor forward(const InputTensor &input) const {
-            return input.tanh().eval();
+            return apply(input);
+        }
+
+        /**
+         * @brief Inference pass on plain values, which never records gradients
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        ValueOutputTensor predict(const ValueInputTensor &input) const {
+            return apply(input);
+        }
+
+        /**
+         * @brief Forward pass overwriting its input with its output, which Net uses when the input is a temporary that
+         *        is no longer needed, saving the output tensor and a pass over memory
+         * @param tensor [in, out]: The input to this layer, which is replaced by the output of this layer
+         */
+        void forwardInPlace(InputTensor &tensor) const {
+            apply(tensor, tensor);
+        }
+
+        /**
+         * @brief Inference pass on plain values overwriting its input with its output (see forwardInPlace())
+         * @param tensor [in, out]: The input to this layer, which is replaced by the output of this layer
+         */
+        void predictInPlace(ValueInputTensor &tensor) const {
+            apply(tensor, tensor);
         }
 
+        /**
+         * @brief Backpropagate a gradient through this layer using the native backpropagation engine
+         * @param input The input given to forward()
+         * @param output The output returned by forward()
+         * @param gradOutput The gradient of the loss with respect to the output of this layer
+         * @return The gradient of the loss with respect to the input of this layer
+         */
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type backward(const InputTensor &input, const OutputTensor &output, const OutputTensor &gradOutput) const {
+            // d/dx tanh(x) = 1 - tanh(x)^2
+            return gradOutput * (output.constant(Dtype(1)) - output.square());
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type attachOptimizer(const OptimizerFactory &factory) {
             // No weights to optimize
         }
 
         template<class Q = Dtype>
-        typename std::enable_if<std::is_same<Q, Derivative>::value, void>::type updateWeights() {
+        typename std::enable_if<IsTrainable<Q>::value, void>::type updateWeights(double /*gradientScale*/ = 1.0) {
             // No weights to adjust here
         }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type mergeGradients(Tanh &replica) {
+            // No gradients to merge
+        }
+
+        template<class Q = Dtype>
+        typename std::enable_if<IsTrainable<Q>::value, void>::type clearGradients() {
+            // No gradients to clear
+        }
+
+        void copyWeights(const Tanh &source) {
+            // No weights to copy
+        }
+
+        void freeze(bool frozen = true) {
+            // No weights to freeze
+        }
+
+    private:
+        /**
+         * @brief Apply the activation function, shared by the auto diff/native forward() and the plain value predict()
+         * @tparam Scalar The scalar type of the tensor
+         * @param input The input to this layer
+         * @return The output of this layer
+         */
+        template <typename Scalar>
+        static Tensor<Scalar, BatchSize, InputSize> apply(const Tensor<Scalar, BatchSize, InputSize> &input) {
+            Tensor<Scalar, BatchSize, InputSize> output;
+            apply(input, output);
+            return output;
+        }
+
+        /**
+         * @brief Apply the activation function into an output tensor, which may be the input tensor itself
+         * @tparam Scalar The scalar type of the tensor
+         * @param input The input to this layer
+         * @param output [out]: The output of this layer
+         */
+        template <typename Scalar>
+        static void apply(const Tensor<Scalar, BatchSize, InputSize> &input, Tensor<Scalar, BatchSize, InputSize> &output) {
+            apply(input, output, std::integral_constant<bool, BatchSize == 1 && IsNative<Scalar>::value>(),
+                  detail::UseApproximation<Accuracy, Scalar>());
+        }
+
+        /**
+         * @brief Apply the activation function to a single sample of plain values, as one vectorized pass over its
+         *        contiguous row, without the temporary of the tensor expression
+         */
+        template <typename Scalar>
+        static void apply(const Tensor<Scalar, BatchSize, InputSize> &input, Tensor<Scalar, BatchSize, InputSize> &output, std::true_type /*singleSample*/, std::false_type /*approximate*/) {
+            TensorToDynamicMatrix<1, InputSize>(output).array() =
+                    activation::Tanh::apply(ConstTensorToDynamicMatrix<1, InputSize>(input).array());
+        }
+
+        /**
+         * @brief Apply the activation function to a batch
+         */
+        template <typename Scalar>
+        static void apply(const Tensor<Scalar, BatchSize, InputSize> &input, Tensor<Scalar, BatchSize, InputSize> &output, std::false_type /*singleSample*/, std::false_type /*approximate*/) {
+            typename Tensor<Scalar, BatchSize, InputSize>::EigenType &result = output;
+            result = input.tanh();
+        }
+
+        /**
+         * @brief Apply the approximation of the accuracy policy to plain values, as one vectorized pass over the batch
+         */
+        template <typename Scalar, typename SingleSample>
+        static void apply(const Tensor<Scalar, BatchSize, InputSize> &input, Tensor<Scalar, BatchSize, InputSize> &output, SingleSample, std::true_type /*approximate*/) {
+            applyTanh<Accuracy>(input.data(), BatchSize * InputSize, output.data());
+        }
     };
 }
 
@@ -11,7 +11,8 @@
 #define NEURAL_CROSSENTROPY_HPP
 
 #include <neural/Tensor.hpp>
-#include <neural/util/Mapping.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Metrics.hpp>
 
 namespace neural {
     /**
@@ -30,9 +31,23 @@ namespace neural {
             return crossEntropy(0) / Dtype(BatchSize);
         }
 
+        /**
+         * @brief Compute the gradient of the loss with respect to the predictions, for use with native backpropagation
+         * @param predictions The predictions given to compute()
+         * @param labels The labels given to compute()
+         * @return The gradient of the loss with respect to the predictions
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type gradient(const InputTensor &predictions, const InputTensor &labels) const {
+            return -labels / (predictions + Dtype(1e-9)) / Dtype(BatchSize);
+        }
+
         Dtype accuracy(const InputTensor &predictions, const InputTensor &labels) const {
-            const Eigen::Tensor<bool, 1> matches = (predictions.argmax(1) == labels.argmax(1));
-            return ConstTensorToMatrix<BatchSize, 1>(matches).count() / Dtype(BatchSize);
+            unsigned int matches = 0;
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                matches += detail::argmax(predictions, i) == detail::argmax(labels, i) ? 1 : 0;
+            }
+            return matches / Dtype(BatchSize);
         }
     };
 }
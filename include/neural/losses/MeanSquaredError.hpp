@@ -11,6 +11,7 @@
 #define NEURAL_MEANSQUAREDERROR_HPP
 
 #include <neural/Tensor.hpp>
+#include <neural/util/Gradient.hpp>
 
 namespace neural {
     /**
@@ -32,6 +33,18 @@ namespace neural {
             Eigen::Tensor<Dtype, 0> squaredSum = (predictionsEigen - labelsEigen).square().sum();
             return squaredSum(0) / Dtype(BatchSize);
         }
+
+        /**
+         * @brief Compute the gradient of the loss with respect to the predictions, for use with native backpropagation
+         * @param predictions The predictions given to compute()
+         * @param labels The labels given to compute()
+         * @return The gradient of the loss with respect to the predictions
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type gradient(const InputTensor &predictions, const InputTensor &labels) const {
+            const typename InputTensor::EigenType &labelsEigen = labels;
+            return (predictions - labelsEigen) * Dtype(2.0 / BatchSize);
+        }
     };
 }
 
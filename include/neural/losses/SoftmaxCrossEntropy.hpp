@@ -0,0 +1,246 @@
+/**
+* \file SoftmaxCrossEntropy.hpp
+*
+* \brief Cross Entropy loss layer fused with a Softmax of its input
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_SOFTMAXCROSSENTROPY_HPP
+#define NEURAL_SOFTMAXCROSSENTROPY_HPP
+
+#include <type_traits>
+#include <Eigen/Core>
+#include <neural/Tensor.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Mapping.hpp>
+#include <neural/util/Metrics.hpp>
+
+namespace neural {
+    namespace detail {
+        /**
+         * @brief Compute the summed softmax cross entropy of a batch of logits, sum_i(lse_i * sum_j(y_ij) - sum_j(y_ij * x_ij)),
+         *        where lse_i = log(sum_j(exp(x_ij))) is computed stably around the maximum of every sample
+         * The columns of the column-major logits are visited once for the maximum and once for the exponentials, label
+         * sums and dot products, so every sample is reduced without any temporaries the size of the batch.
+         * @tparam BatchSize The number of samples (rows)
+         * @tparam InputSize The number of classes (columns)
+         * @param logits The BatchSize x InputSize logits, in column-major order
+         * @param labels The BatchSize x InputSize labels, in column-major order
+         * @param logSumExp The BatchSize log-sum-exps of the samples, which are written
+         * @param labelSums The BatchSize sums of the labels of the samples, which are written
+         * @return The summed loss of the batch
+         */
+        template <unsigned int BatchSize, unsigned int InputSize, typename Scalar>
+        Scalar softmaxCrossEntropy(const Scalar *logits, const Scalar *labels, Scalar *logSumExp, Scalar *labelSums) {
+            using ArrayMap = Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+            using ConstArrayMap = Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+            ArrayMap maximum(logSumExp, BatchSize);
+            ArrayMap labelSum(labelSums, BatchSize);
+            maximum = ConstArrayMap(logits, BatchSize);
+            for (unsigned int j = 1; j < InputSize; j++) {
+                maximum = maximum.max(ConstArrayMap(logits + j * BatchSize, BatchSize));
+            }
+
+            Eigen::Array<Scalar, BatchSize, 1> sumExp = Eigen::Array<Scalar, BatchSize, 1>::Zero();
+            Eigen::Array<Scalar, BatchSize, 1> labelDot = Eigen::Array<Scalar, BatchSize, 1>::Zero();
+            labelSum.setZero();
+            for (unsigned int j = 0; j < InputSize; j++) {
+                const ConstArrayMap x(logits + j * BatchSize, BatchSize);
+                const ConstArrayMap y(labels + j * BatchSize, BatchSize);
+                sumExp += (x - maximum).exp();
+                labelSum += y;
+                labelDot += y * x;
+            }
+            maximum += sumExp.log();
+            return (maximum * labelSum - labelDot).sum();
+        }
+
+        /**
+         * @brief Compute the gradient of the softmax cross entropy with respect to the logits, scale * (p * sum_j(y_ij) - y),
+         *        where p is the softmax of the logits. For one-hot or normalized labels, this is scale * (p - y)
+         * @tparam BatchSize The number of samples (rows)
+         * @tparam InputSize The number of classes (columns)
+         * @param logits The BatchSize x InputSize logits, in column-major order
+         * @param labels The BatchSize x InputSize labels, in column-major order
+         * @param logSumExp The BatchSize log-sum-exps computed by softmaxCrossEntropy()
+         * @param labelSums The BatchSize label sums computed by softmaxCrossEntropy()
+         * @param scale The factor to scale the gradient by
+         * @param gradient The BatchSize x InputSize gradient, in column-major order, which is written
+         */
+        template <unsigned int BatchSize, unsigned int InputSize, typename Scalar>
+        void softmaxCrossEntropyGradient(const Scalar *logits, const Scalar *labels, const Scalar *logSumExp,
+                                         const Scalar *labelSums, Scalar scale, Scalar *gradient) {
+            using ArrayMap = Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+            using ConstArrayMap = Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+            const ConstArrayMap lse(logSumExp, BatchSize);
+            const ConstArrayMap labelSum(labelSums, BatchSize);
+            for (unsigned int j = 0; j < InputSize; j++) {
+                const ConstArrayMap x(logits + j * BatchSize, BatchSize);
+                const ConstArrayMap y(labels + j * BatchSize, BatchSize);
+                ArrayMap(gradient + j * BatchSize, BatchSize) = scale * ((x - lse).exp() * labelSum - y);
+            }
+        }
+    }
+}
+
+#ifdef AUTO_DIFF_ENABLED
+namespace neural {
+    namespace detail {
+        /**
+         * @brief Stan Math vari that records a softmax cross entropy loss as a single node on the auto diff tape
+         * Recording the softmax and the logarithms scalar by scalar results in several nodes per logit. Instead, this
+         * node evaluates the loss using plain doubles, and propagates its adjoint to the logits using the closed-form
+         * gradient, dx = dL * (p - y) / BatchSize. The labels are treated as constants.
+         * @tparam InputSize The number of classes
+         * @tparam BatchSize The batch size to use
+         */
+        template <unsigned int InputSize, unsigned int BatchSize>
+        class SoftmaxCrossEntropyVari: public stan::math::vari {
+        public:
+            /**
+             * @brief Record a softmax cross entropy loss on the tape
+             * @param logitVaris The BatchSize x InputSize varis of the logits, allocated on the arena
+             * @param logits The BatchSize x InputSize values of the logits, allocated on the arena
+             * @param labels The BatchSize x InputSize values of the labels, allocated on the arena
+             * @param logSumExp The BatchSize log-sum-exps of the samples, allocated on the arena
+             * @param labelSums The BatchSize label sums of the samples, allocated on the arena
+             * @param loss The value of the loss
+             */
+            SoftmaxCrossEntropyVari(stan::math::vari **logitVaris, const BaseType *logits, const BaseType *labels,
+                                    const BaseType *logSumExp, const BaseType *labelSums, BaseType loss):
+                    vari(loss), m_logitVaris(logitVaris), m_logits(logits), m_labels(labels), m_logSumExp(logSumExp),
+                    m_labelSums(labelSums) {
+            }
+
+            /**
+             * @brief Record the loss of a batch of logits on the tape
+             * @param logits The BatchSize x InputSize logits, in column-major order
+             * @param labels The BatchSize x InputSize labels, in column-major order
+             * @return The node of the loss
+             */
+            static SoftmaxCrossEntropyVari* record(const Derivative *logits, const Derivative *labels) {
+                // Copy the varis and values of the logits and the values of the labels onto the arena
+                auto &memory = stan::math::ChainableStack::memalloc_;
+                auto **logitVaris = memory.alloc_array<stan::math::vari*>(BatchSize * InputSize);
+                auto *logitValues = memory.alloc_array<BaseType>(BatchSize * InputSize);
+                auto *labelValues = memory.alloc_array<BaseType>(BatchSize * InputSize);
+                for (unsigned int i = 0; i < BatchSize * InputSize; i++) {
+                    logitVaris[i] = logits[i].vi_;
+                    logitValues[i] = logits[i].vi_->val_;
+                    labelValues[i] = labels[i].vi_->val_;
+                }
+
+                auto *logSumExp = memory.alloc_array<BaseType>(BatchSize);
+                auto *labelSums = memory.alloc_array<BaseType>(BatchSize);
+                const BaseType loss = softmaxCrossEntropy<BatchSize, InputSize>(logitValues, labelValues, logSumExp, labelSums);
+                return new SoftmaxCrossEntropyVari(logitVaris, logitValues, labelValues, logSumExp, labelSums,
+                                                   loss / BaseType(BatchSize));
+            }
+
+            void chain() override {
+                // Scratch space is taken from the arena as well, so the backward pass doesn't touch the heap
+                auto *gradient = stan::math::ChainableStack::memalloc_.alloc_array<BaseType>(BatchSize * InputSize);
+                softmaxCrossEntropyGradient<BatchSize, InputSize>(m_logits, m_labels, m_logSumExp, m_labelSums,
+                                                                  adj_ / BaseType(BatchSize), gradient);
+                for (unsigned int i = 0; i < BatchSize * InputSize; i++) {
+                    m_logitVaris[i]->adj_ += gradient[i];
+                }
+            }
+
+        private:
+            stan::math::vari** m_logitVaris;    ///< The varis of the logits
+            const BaseType* m_logits;           ///< The values of the logits
+            const BaseType* m_labels;           ///< The values of the labels
+            const BaseType* m_logSumExp;        ///< The log-sum-exps of the samples
+            const BaseType* m_labelSums;        ///< The label sums of the samples
+        };
+    }
+}
+
+#else
+
+// Inference-only mode - autodiff/gradients are not available
+// Forward declaration to keep compiler happy (this can never be instantiated due to std::enable_if usage)
+namespace neural {
+    namespace detail {
+        template <unsigned int InputSize, unsigned int BatchSize>
+        class SoftmaxCrossEntropyVari;
+    }
+}
+
+#endif //AUTO_DIFF_ENABLED
+
+namespace neural {
+    /**
+     * @brief Cross Entropy loss layer fused with a Softmax of its input, which takes the logits of the last layer
+     *        instead of probabilities
+     * The loss of every sample is computed as log-sum-exp(x) - sum(y * x) in a single reduction over its logits, which is
+     * numerically stable for any magnitude of logits and never takes the logarithm of a vanishing probability. The
+     * gradient with respect to the logits is the closed form (softmax(x) - y) / BatchSize, so a net trained with this
+     * loss ends in its last linear layer instead of a Softmax layer, and auto diff records a single node for the loss.
+     * Use a Softmax layer to turn the logits into probabilities for inference.
+     * @tparam Dtype The scalar type to use for this loss layer
+     * @tparam InputSize The number of inputs (classes) to this loss layer
+     * @tparam BatchSize The batch size to use
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int BatchSize>
+    class SoftmaxCrossEntropy {
+    public:
+        using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
+
+        /**
+         * @brief Compute the loss of a batch of logits
+         * @param logits The logits, i.e. the unnormalized log probabilities
+         * @param labels The labels, which are one-hot or normalized probabilities
+         * @return The loss, averaged over the batch
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<!std::is_same<Q, Derivative>::value, Dtype>::type compute(const InputTensor &logits, const InputTensor &labels) const {
+            Eigen::Array<Dtype, BatchSize, 1> logSumExp, labelSums;
+            return detail::softmaxCrossEntropy<BatchSize, InputSize>(logits.data(), labels.data(), logSumExp.data(),
+                                                                     labelSums.data()) / Dtype(BatchSize);
+        }
+
+        /**
+         * @brief Auto diff loss, which records the whole loss as a single node on the tape. The labels are constants,
+         *        so no gradients are propagated to them
+         * @param logits The logits, i.e. the unnormalized log probabilities
+         * @param labels The labels, which are one-hot or normalized probabilities
+         * @return The loss, averaged over the batch
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<std::is_same<Q, Derivative>::value, Dtype>::type compute(const InputTensor &logits, const InputTensor &labels) const {
+            return Derivative(detail::SoftmaxCrossEntropyVari<InputSize, BatchSize>::record(logits.data(), labels.data()));
+        }
+
+        /**
+         * @brief Compute the gradient of the loss with respect to the logits, for use with native backpropagation
+         * @param logits The logits given to compute()
+         * @param labels The labels given to compute()
+         * @return The gradient of the loss with respect to the logits, (softmax(logits) - labels) / BatchSize
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type gradient(const InputTensor &logits, const InputTensor &labels) const {
+            Eigen::Array<Dtype, BatchSize, 1> logSumExp, labelSums;
+            detail::softmaxCrossEntropy<BatchSize, InputSize>(logits.data(), labels.data(), logSumExp.data(), labelSums.data());
+            InputTensor result;
+            detail::softmaxCrossEntropyGradient<BatchSize, InputSize>(logits.data(), labels.data(), logSumExp.data(),
+                                                                      labelSums.data(), Dtype(1) / Dtype(BatchSize),
+                                                                      result.data());
+            return result;
+        }
+
+        Dtype accuracy(const InputTensor &logits, const InputTensor &labels) const {
+            // The softmax preserves the order of the logits, so the predicted class is the largest logit
+            unsigned int matches = 0;
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                matches += detail::argmax(logits, i) == detail::argmax(labels, i) ? 1 : 0;
+            }
+            return matches / Dtype(BatchSize);
+        }
+    };
+}
+
+#endif //NEURAL_SOFTMAXCROSSENTROPY_HPP
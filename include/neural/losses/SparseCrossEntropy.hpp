@@ -0,0 +1,98 @@
+/**
+* \file SparseCrossEntropy.hpp
+*
+* \brief Cross Entropy loss layer taking the labels as class indices
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_SPARSECROSSENTROPY_HPP
+#define NEURAL_SPARSECROSSENTROPY_HPP
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <neural/Tensor.hpp>
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Metrics.hpp>
+
+namespace neural {
+    /**
+     * @brief Cross Entropy loss layer taking the labels as class indices instead of one-hot tensors
+     * Only the predicted probability of the labelled class of every sample is gathered, so auto diff records a few
+     * nodes per sample instead of an operation per class, and no one-hot labels need to be built for every batch.
+     * @tparam Dtype The scalar type to use for this loss layer
+     * @tparam InputSize The number of inputs (classes) to this loss layer
+     * @tparam BatchSize The batch size to use
+     */
+    template <typename Dtype, unsigned int InputSize, unsigned int BatchSize>
+    class SparseCrossEntropy {
+    public:
+        using InputTensor = Tensor<Dtype, BatchSize, InputSize>;
+        using LabelArray = std::array<int, BatchSize>;     ///< The class index of every sample in a batch
+
+        /**
+         * @brief Compute the loss of a batch of predictions
+         * @param predictions The predicted probabilities
+         * @param labels The class index of every sample, which must be in [0, InputSize)
+         * @return The loss, averaged over the batch
+         */
+        Dtype compute(const InputTensor &predictions, const LabelArray &labels) const {
+            using std::log;
+            checkLabels(labels);
+            Dtype crossEntropy = 0;
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                crossEntropy -= log(predictions(i, labels[i]) + Dtype(1e-9));
+            }
+            return crossEntropy / Dtype(BatchSize);
+        }
+
+        /**
+         * @brief Compute the gradient of the loss with respect to the predictions, for use with native backpropagation
+         * @param predictions The predictions given to compute()
+         * @param labels The labels given to compute()
+         * @return The gradient of the loss with respect to the predictions, which is non-zero only for the labelled classes
+         */
+        template<class Q = Dtype>
+        typename std::enable_if<IsNative<Q>::value, InputTensor>::type gradient(const InputTensor &predictions, const LabelArray &labels) const {
+            checkLabels(labels);
+            InputTensor result;
+            result.setZero();
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                result(i, labels[i]) = -Dtype(1) / (predictions(i, labels[i]) + Dtype(1e-9)) / Dtype(BatchSize);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Compute the fraction of samples whose most probable class is the labelled class
+         * @param predictions The predicted probabilities, or any other scores with the same order, e.g. logits
+         * @param labels The class index of every sample
+         * @return The accuracy
+         */
+        typename ValueType<Dtype>::type accuracy(const InputTensor &predictions, const LabelArray &labels) const {
+            unsigned int matches = 0;
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                matches += static_cast<int>(detail::argmax(predictions, i)) == labels[i] ? 1 : 0;
+            }
+            return matches / typename ValueType<Dtype>::type(BatchSize);
+        }
+
+    private:
+        /**
+         * @brief Check that the labels are valid class indices
+         * @param labels The class index of every sample
+         */
+        static void checkLabels(const LabelArray &labels) {
+            for (const int label: labels) {
+                if (label < 0 || label >= static_cast<int>(InputSize)) {
+                    throw std::runtime_error("Labels must be class indices in [0, InputSize)");
+                }
+            }
+        }
+    };
+}
+
+#endif //NEURAL_SPARSECROSSENTROPY_HPP
@@ -11,7 +11,7 @@
 #define NEURAL_ADAM_HPP
 
 #include <neural/optimizers/Optimizer.hpp>
-#include <neural/util/Gradient.hpp>
+#include <cmath>
 
 namespace neural {
     /**
@@ -21,7 +21,7 @@ namespace neural {
     template <typename Tensor>
     class AdamOptimizer: public Optimizer<Tensor> {
     public:
-        using GradTensor = typename Optimizer<Tensor>::GradTensor;
+        using Scalar = typename Optimizer<Tensor>::Scalar;
 
         AdamOptimizer(double learningRate, double beta1, double beta2, double epsilon):
                 m_learningRate(learningRate), m_beta1(beta1), m_beta2(beta2), m_epsilon(epsilon), m_currentStep(1) {
@@ -29,22 +29,24 @@ namespace neural {
             m_secondMoment.setZero();
         }
 
-        GradTensor update(const Tensor &tensor) override {
-            const auto grad = tensor.unaryExpr(std::cref(getGradient));
+        void update(Tensor &tensor, const Tensor &gradient) override {
+            const auto grad = this->map(gradient);
+            auto firstMoment = this->map(m_firstMoment);
+            auto secondMoment = this->map(m_secondMoment);
 
             // Calculate first and second moments (mean and uncentered variance)
-            m_firstMoment = m_beta1 * m_firstMoment + (1 - m_beta1) * grad;
-            m_secondMoment = m_beta2 * m_secondMoment + (1 - m_beta2) * grad.square();
+            firstMoment = Scalar(m_beta1) * firstMoment + Scalar(1 - m_beta1) * grad;
+            secondMoment = Scalar(m_beta2) * secondMoment + Scalar(1 - m_beta2) * grad.square();
 
             // Apply bias corrections
-            const auto firstMomentCorrected = m_firstMoment / (1 - std::pow(m_beta1, m_currentStep));
-            const auto secondMomentCorrected = m_secondMoment / (1 - std::pow(m_beta2, m_currentStep));
+            const auto firstMomentCorrected = firstMoment / Scalar(1 - std::pow(m_beta1, m_currentStep));
+            const auto secondMomentCorrected = secondMoment / Scalar(1 - std::pow(m_beta2, m_currentStep));
 
             // Update current step
             m_currentStep++;
 
-            // Return update
-            return (m_learningRate / (secondMomentCorrected.sqrt() + m_epsilon)) * firstMomentCorrected;
+            // Apply update
+            this->map(tensor) -= Scalar(m_learningRate) * firstMomentCorrected / (secondMomentCorrected.sqrt() + Scalar(m_epsilon));
         }
 
     private:
@@ -52,8 +54,8 @@ namespace neural {
         double m_beta1;
         double m_beta2;
         double m_epsilon;
-        GradTensor m_firstMoment{};
-        GradTensor m_secondMoment{};
+        Tensor m_firstMoment{};
+        Tensor m_secondMoment{};
         unsigned int m_currentStep;
     };
 }
@@ -11,6 +11,7 @@
 #define NEURAL_OPTIMIZER_HPP
 
 #include <neural/Tensor.hpp>
+#include <Eigen/Core>
 
 namespace neural {
     /**
@@ -20,9 +21,40 @@ namespace neural {
     template <typename Tensor>
     class Optimizer {
     public:
-        using GradTensor = neural::Tensor<double, Tensor::BatchSize, Tensor::ChannelSize>;
+        using Scalar = typename Tensor::Dtype;
+        using ArrayMap = Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+        using ConstArrayMap = Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+        enum {
+            Size = Tensor::BatchSize * Tensor::ChannelSize  ///< The number of elements in the optimized tensor
+        };
 
-        virtual GradTensor update(const Tensor &tensor) = 0;
+        virtual ~Optimizer() = default;
+
+        /**
+         * @brief Update a tensor in place given its gradient
+         * @param tensor [in/out]: The tensor to update
+         * @param gradient The gradient of the loss with respect to the tensor
+         */
+        virtual void update(Tensor &tensor, const Tensor &gradient) = 0;
+
+    protected:
+        /**
+         * @brief Map the contiguous storage of a tensor to a flat Eigen Array, so updates stream linearly through memory
+         * @param tensor The tensor to map
+         * @return The tensor mapped to an Eigen Array
+         */
+        static ArrayMap map(Tensor &tensor) {
+            return ArrayMap(tensor.data(), Size);
+        }
+
+        /**
+         * @brief Map the contiguous storage of a const tensor to a flat Eigen Array
+         * @param tensor The tensor to map
+         * @return The tensor mapped to a const Eigen Array
+         */
+        static ConstArrayMap map(const Tensor &tensor) {
+            return ConstArrayMap(tensor.data(), Size);
+        }
     };
 }
 
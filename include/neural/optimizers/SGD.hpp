@@ -11,7 +11,6 @@
 #define NEURAL_SGD_HPP
 
 #include <neural/optimizers/Optimizer.hpp>
-#include <neural/util/Gradient.hpp>
 
 namespace neural {
     /**
@@ -21,23 +20,23 @@ namespace neural {
     template <typename Tensor>
     class SGDOptimizer: public Optimizer<Tensor> {
     public:
-        using GradTensor = typename Optimizer<Tensor>::GradTensor;
+        using Scalar = typename Optimizer<Tensor>::Scalar;
 
         SGDOptimizer(double learningRate, double momentum):
                 m_learningRate(learningRate), m_momentum(momentum), m_lastUpdate() {
             m_lastUpdate.setZero();
         }
 
-        GradTensor update(const Tensor &tensor) override {
-            const auto grad = tensor.unaryExpr(std::cref(getGradient));
-            m_lastUpdate = m_momentum * m_lastUpdate + m_learningRate * grad;
-            return m_lastUpdate;
+        void update(Tensor &tensor, const Tensor &gradient) override {
+            auto lastUpdate = this->map(m_lastUpdate);
+            lastUpdate = Scalar(m_momentum) * lastUpdate + Scalar(m_learningRate) * this->map(gradient);
+            this->map(tensor) -= lastUpdate;
         }
 
     private:
         double m_learningRate;
         double m_momentum;
-        GradTensor m_lastUpdate;
+        Tensor m_lastUpdate;
     };
 }
 
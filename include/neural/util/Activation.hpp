@@ -0,0 +1,158 @@
+/**
+* \file Activation.hpp
+*
+* \brief Activation functions that can be fused into the write-back of a layer's output
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_ACTIVATION_HPP
+#define NEURAL_ACTIVATION_HPP
+
+#include <Eigen/Core>
+
+namespace neural {
+    namespace detail {
+        /**
+         * @brief Apply an activation in place to a packet of the matrix product kernels (see Gemm.hpp) through its
+         *        lanes, for activations that are computed by Eigen
+         * @tparam Activation The activation function
+         * @tparam P The packet operations
+         * @tparam Scalar The scalar type
+         * @param x The packet
+         */
+        template <typename Activation, typename P, typename Scalar>
+        inline void applyLanes(typename P::Packet &x) {
+            Scalar lanes[P::Lanes];
+            P::store(lanes, x);
+            Eigen::Map<Eigen::Array<Scalar, P::Lanes, 1>> mapped(lanes);
+            mapped = Activation::apply(mapped);
+            P::load(lanes, x);
+        }
+    }
+
+    /**
+     * @brief Activation functions that can be fused into the write-back of a layer's output
+     * Every activation provides apply(), which maps an Eigen array expression of pre-activations to an expression of
+     * activations, and applyPacket(), which applies the activation to a tile of the output held in registers by the
+     * matrix product kernels before it is stored. It also provides derivative(), which computes the derivative of the
+     * activation from its output.
+     */
+    namespace activation {
+        /**
+         * @brief No activation, y = x
+         */
+        struct Identity {
+            template<typename Expr>
+            static Expr apply(const Expr &x) {
+                return x;
+            }
+
+            template<typename P, typename Scalar>
+            static void applyPacket(typename P::Packet &x) {
+                // Noop
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(Scalar y) {
+                return Scalar(1);
+            }
+        };
+
+        /**
+         * @brief Rectified linear unit, y = max(x, 0)
+         */
+        struct Relu {
+            template<typename Expr>
+            static auto apply(const Expr &x) -> decltype(x.max(typename Expr::Scalar(0))) {
+                return x.max(typename Expr::Scalar(0));
+            }
+
+            template<typename P, typename Scalar>
+            static void applyPacket(typename P::Packet &x) {
+                typename P::Packet zero;
+                P::zero(zero);
+                P::max(x, zero, x);
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(Scalar y) {
+                return y > Scalar(0) ? Scalar(1) : Scalar(0);
+            }
+        };
+
+        /**
+         * @brief Logistic sigmoid, y = 1 / (1 + exp(-x))
+         */
+        struct Sigmoid {
+            template<typename Expr>
+            static auto apply(const Expr &x) -> decltype(((-x).exp() + typename Expr::Scalar(1)).inverse()) {
+                return ((-x).exp() + typename Expr::Scalar(1)).inverse();
+            }
+
+            template<typename P, typename Scalar>
+            static void applyPacket(typename P::Packet &x) {
+                detail::applyLanes<Sigmoid, P, Scalar>(x);
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(Scalar y) {
+                return y * (Scalar(1) - y);
+            }
+        };
+
+        /**
+         * @brief Hyperbolic tangent, y = tanh(x)
+         */
+        struct Tanh {
+            template<typename Expr>
+            static auto apply(const Expr &x) -> decltype(x.tanh()) {
+                return x.tanh();
+            }
+
+            template<typename P, typename Scalar>
+            static void applyPacket(typename P::Packet &x) {
+                detail::applyLanes<Tanh, P, Scalar>(x);
+            }
+
+            template<typename Scalar>
+            static Scalar derivative(Scalar y) {
+                return Scalar(1) - y * y;
+            }
+        };
+    }
+
+    namespace detail {
+        /**
+         * @brief Add a bias to every column of an output and apply an activation, in a pass over an output that has
+         *        already been written, for products that cannot apply them to their tiles in registers
+         * @tparam Activation The activation function
+         * @tparam Rows The number of rows of the output
+         * @tparam Columns The number of columns of the output
+         * @tparam Scalar The scalar type
+         * @param output The Rows x Columns output, in column-major order
+         * @param bias The Columns biases, or nullptr for no bias
+         */
+        template <typename Activation, unsigned int Rows, unsigned int Columns, typename Scalar>
+        inline void applyEpilogue(Scalar *output, const Scalar *bias) {
+            using Array = Eigen::Array<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+            Eigen::Map<Array> mapped(output, Rows, Columns);
+            if (Rows == 1) {
+                // A single row is contiguous, and is vectorized as a whole instead of column by column
+                if (bias != nullptr) {
+                    mapped = Activation::apply(mapped + Eigen::Map<const Array>(bias, 1, Columns));
+                } else {
+                    mapped = Activation::apply(mapped);
+                }
+                return;
+            }
+            for (unsigned int j = 0; j < Columns; j++) {
+                auto column = mapped.col(j);
+                column = Activation::apply(column + (bias != nullptr ? bias[j] : Scalar(0)));
+            }
+        }
+    }
+}
+
+#endif //NEURAL_ACTIVATION_HPP
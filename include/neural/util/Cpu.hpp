@@ -0,0 +1,218 @@
+/**
+* \file Cpu.hpp
+*
+* \brief Instruction sets, detection of the instruction sets supported by the CPU, and runtime dispatch of kernels
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_CPU_HPP
+#define NEURAL_CPU_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+/*
+ * On x86-64 with GCC or Clang, the SIMD kernels are compiled for every instruction set using target attributes, and
+ * the widest one supported by the CPU is selected at runtime, so a binary built for the SSE2 baseline still runs its
+ * matrix products at full speed on AVX2 and AVX-512 machines. Define NEURAL_NO_RUNTIME_DISPATCH to only use the
+ * instruction sets enabled at compile time.
+ * Only the entry points of the kernels and the SIMD packet operations are compiled with target attributes. As the
+ * rest of a kernel may be compiled for the baseline instruction set, vectors are never passed by value between
+ * functions, only through pointers and references, so the kernels are correct whether or not they are inlined.
+ */
+#if !defined(NEURAL_NO_RUNTIME_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define NEURAL_RUNTIME_DISPATCH
+#define NEURAL_TARGET(isa) __attribute__((target(isa)))
+#define NEURAL_FLATTEN __attribute__((flatten))
+#else
+#define NEURAL_TARGET(isa)
+#define NEURAL_FLATTEN
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NEURAL_NOINLINE __attribute__((noinline))
+#else
+#define NEURAL_NOINLINE
+#endif
+
+#define NEURAL_TARGET_AVX2 NEURAL_TARGET("avx2,fma")
+#define NEURAL_TARGET_AVX512 NEURAL_TARGET("avx512f,avx2,fma")
+#define NEURAL_TARGET_AVX512VNNI NEURAL_TARGET("avx512f,avx512bw,avx512vnni,avx2,fma")
+
+namespace neural {
+    /**
+     * @brief Instruction sets the kernels are implemented for, ordered so every instruction set includes the previous
+     */
+    enum class Isa {
+        Scalar,         ///< No SIMD instructions
+        SSE2,           ///< SSE2, the baseline of x86-64
+        AVX2,           ///< AVX2 and FMA
+        AVX512,         ///< AVX-512 Foundation
+        AVX512VNNI      ///< AVX-512 with the byte and word instructions and VNNI, used by the int8 kernels
+    };
+
+    /// Tag type of an instruction set, used to select the kernels of an instruction set at compile time
+    template <Isa I>
+    using IsaTag = std::integral_constant<Isa, I>;
+
+    /// The widest instruction set enabled at compile time
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    constexpr Isa NativeIsa = Isa::AVX512VNNI;
+#elif defined(__AVX512F__)
+    constexpr Isa NativeIsa = Isa::AVX512;
+#elif defined(__AVX2__) && defined(__FMA__)
+    constexpr Isa NativeIsa = Isa::AVX2;
+#elif defined(__SSE2__) || defined(__x86_64__)
+    constexpr Isa NativeIsa = Isa::SSE2;
+#else
+    constexpr Isa NativeIsa = Isa::Scalar;
+#endif
+
+    /**
+     * @brief Get the name of an instruction set, which is also the value of NEURAL_ISA that selects it
+     * @param isa The instruction set
+     * @return The name
+     */
+    inline const char* isaName(Isa isa) {
+        static const char* const names[] = {"scalar", "sse2", "avx2", "avx512", "avx512vnni"};
+        return names[static_cast<int>(isa)];
+    }
+
+    namespace detail {
+        /**
+         * @brief Detect the widest instruction set supported by the CPU and the operating system
+         * The environment variable NEURAL_ISA (see isaName()) caps the detected instruction set, e.g. to compare the
+         * kernels of different instruction sets on one machine. Instruction sets below the one enabled at compile time
+         * are never used, as the rest of the program requires it anyway
+         * @return The instruction set to run the kernels with
+         */
+        inline Isa detectIsa() {
+#if defined(NEURAL_RUNTIME_DISPATCH)
+            __builtin_cpu_init();
+            Isa isa = Isa::SSE2;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                isa = Isa::AVX2;
+                if (__builtin_cpu_supports("avx512f")) {
+                    isa = Isa::AVX512;
+                    if (__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni")) {
+                        isa = Isa::AVX512VNNI;
+                    }
+                }
+            }
+
+            const char *requested = std::getenv("NEURAL_ISA");
+            if (requested != nullptr) {
+                for (int i = static_cast<int>(Isa::Scalar); i < static_cast<int>(isa); i++) {
+                    if (std::strcmp(requested, isaName(static_cast<Isa>(i))) == 0) {
+                        isa = static_cast<Isa>(i);
+                    }
+                }
+            }
+            return isa > NativeIsa ? isa : NativeIsa;
+#else
+            return NativeIsa;
+#endif
+        }
+    }
+
+    /**
+     * @brief Get the instruction set the kernels run with, which is detected once on the first call
+     * @return The instruction set
+     */
+    inline Isa cpuIsa() {
+        static const Isa isa = detail::detectIsa();
+        return isa;
+    }
+
+    namespace detail {
+        /**
+         * @brief Get the instruction set to compile the kernels of a dispatched instruction set for
+         * @param isa The dispatched instruction set
+         * @param maxIsa The widest instruction set the kernels are implemented for
+         * @return isa capped to maxIsa, but never below the instruction set enabled at compile time
+         */
+        constexpr Isa kernelIsa(Isa isa, Isa maxIsa) {
+            return isa > maxIsa ? (maxIsa > NativeIsa ? maxIsa : NativeIsa) : (isa > NativeIsa ? isa : NativeIsa);
+        }
+
+        /**
+         * @brief Run a kernel with an instruction set enabled at compile time
+         * @param isa The tag of the instruction set
+         * @param kernel The kernel, a function object taking the tag of the instruction set
+         */
+        template <Isa I, typename Kernel>
+        NEURAL_FLATTEN inline void runKernel(IsaTag<I> isa, const Kernel &kernel) {
+            kernel(isa);
+        }
+
+        /**
+         * @brief Run a kernel compiled for AVX2, taking its operands through the pointers in the kernel function object.
+         *        Flattening inlines the whole kernel, so all of it is compiled for AVX2 when optimizing
+         */
+        template <typename Kernel>
+        NEURAL_TARGET_AVX2 NEURAL_FLATTEN inline void runKernel(IsaTag<Isa::AVX2> isa, const Kernel &kernel) {
+            kernel(isa);
+        }
+
+        /**
+         * @brief Run a kernel compiled for AVX-512
+         */
+        template <typename Kernel>
+        NEURAL_TARGET_AVX512 NEURAL_FLATTEN inline void runKernel(IsaTag<Isa::AVX512> isa, const Kernel &kernel) {
+            kernel(isa);
+        }
+
+        /**
+         * @brief Run a kernel compiled for AVX-512 VNNI
+         */
+        template <typename Kernel>
+        NEURAL_TARGET_AVX512VNNI NEURAL_FLATTEN inline void runKernel(IsaTag<Isa::AVX512VNNI> isa, const Kernel &kernel) {
+            kernel(isa);
+        }
+
+        /**
+         * @brief Run a kernel with a given instruction set
+         * @tparam MaxIsa The widest instruction set the kernel is implemented for, which is used for wider ones
+         * @param kernel The kernel, a function object whose call operator is templated on the tag of the instruction set
+         * @param isa The instruction set, which must be supported by the CPU. Without runtime dispatch, the instruction
+         *        set enabled at compile time is always used
+         */
+        template <Isa MaxIsa, typename Kernel>
+        inline void dispatch(const Kernel &kernel, Isa isa) {
+#if defined(NEURAL_RUNTIME_DISPATCH)
+            switch (isa) {
+                case Isa::AVX512VNNI:
+                    runKernel(IsaTag<kernelIsa(Isa::AVX512VNNI, MaxIsa)>(), kernel);
+                    break;
+                case Isa::AVX512:
+                    runKernel(IsaTag<kernelIsa(Isa::AVX512, MaxIsa)>(), kernel);
+                    break;
+                case Isa::AVX2:
+                    runKernel(IsaTag<kernelIsa(Isa::AVX2, MaxIsa)>(), kernel);
+                    break;
+                default:
+                    runKernel(IsaTag<kernelIsa(Isa::SSE2, MaxIsa)>(), kernel);
+                    break;
+            }
+#else
+            runKernel(IsaTag<kernelIsa(NativeIsa, MaxIsa)>(), kernel);
+#endif
+        }
+
+        /**
+         * @brief Run a kernel with the widest instruction set supported by the CPU (see cpuIsa())
+         * @tparam MaxIsa The widest instruction set the kernel is implemented for, which is used on CPUs that support
+         *         wider ones
+         * @param kernel The kernel, a function object whose call operator is templated on the tag of the instruction set
+         */
+        template <Isa MaxIsa, typename Kernel>
+        inline void dispatch(const Kernel &kernel) {
+            dispatch<MaxIsa>(kernel, cpuIsa());
+        }
+    }
+}
+
+#endif //NEURAL_CPU_HPP
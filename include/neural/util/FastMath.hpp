@@ -0,0 +1,445 @@
+/**
+* \file FastMath.hpp
+*
+* \brief Vectorized polynomial approximations of exp, tanh and sigmoid with selectable accuracy
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_FASTMATH_HPP
+#define NEURAL_FASTMATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <Eigen/Core>
+#include <neural/util/Activation.hpp>
+#include <neural/util/Cpu.hpp>
+#include <neural/util/Gemm.hpp>
+#include <neural/util/Gradient.hpp>
+
+namespace neural {
+    /**
+     * @brief Accuracy policies of the activation functions of the Sigmoid, Tanh and Softmax layers
+     * Approximate policies compute exp(x) = 2^n * exp(r), where n = round(x / log(2)) and |r| <= log(2) / 2, using a
+     * polynomial of exp(r) on SIMD packets, and derive tanh(x) = (1 - exp(-2x)) / (1 + exp(-2x)) and
+     * sigmoid(x) = 1 / (1 + exp(-x)) from it. As 1 - exp(-2x) cancels for small |x|, tanh(x) is computed as x * p(x^2)
+     * using its Taylor series below |x| = 1/4 instead. The errors below are relative for exp, tanh and sigmoid, except
+     * that sigmoid(x) is only accurate in absolute terms where exp(-x) is clamped. Arguments of exp are clamped to the
+     * range where 2^n is a normal number, so it never returns 0 or infinity. Auto diff forward passes always compute
+     * exact activations.
+     */
+    namespace accuracy {
+        /**
+         * @brief Exact activations, computed by Eigen and the standard library
+         */
+        struct Exact {};
+
+        /**
+         * @brief Approximate activations with errors of about 1e-6 (limited by the precision of float)
+         */
+        struct High {
+            enum {
+                ExpDegree = 6,          ///< The degree of the polynomial of exp(r)
+                TanhDegree = 4          ///< The degree in x^2 of the polynomial of tanh(x) / x near zero
+            };
+        };
+
+        /**
+         * @brief Approximate activations with errors of about 1e-3
+         */
+        struct Low {
+            enum {
+                ExpDegree = 3,          ///< The degree of the polynomial of exp(r)
+                TanhDegree = 2          ///< The degree in x^2 of the polynomial of tanh(x) / x near zero
+            };
+        };
+    }
+
+    namespace detail {
+        /**
+         * @brief Whether a layer computes the approximation of an accuracy policy for a scalar type, which is only done
+         *        for plain values
+         * @tparam Accuracy The accuracy policy
+         * @tparam Scalar The scalar type
+         */
+        template <typename Accuracy, typename Scalar>
+        struct UseApproximation: std::integral_constant<bool, IsNative<Scalar>::value && !std::is_same<Accuracy, accuracy::Exact>::value> {};
+
+        /**
+         * @brief The packet operations of SimdPacket, extended with the arithmetic used by the approximations
+         * @tparam Scalar The scalar type
+         * @tparam I The instruction set
+         */
+        template <typename Scalar, Isa I = NativeIsa>
+        struct MathPacket: ScalarPacket<Scalar> {
+            using Packet = Scalar;
+
+            static void add(const Packet &a, const Packet &b, Packet &result) { result = a + b; }
+            static void sub(const Packet &a, const Packet &b, Packet &result) { result = a - b; }
+            static void mul(const Packet &a, const Packet &b, Packet &result) { result = a * b; }
+            static void div(const Packet &a, const Packet &b, Packet &result) { result = a / b; }
+            static void min(const Packet &a, const Packet &b, Packet &result) { result = std::min(a, b); }
+            static void abs(const Packet &a, Packet &result) { result = std::abs(a); }
+            static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) { result = a < b ? less : otherwise; }  ///< less where a < b, otherwise elsewhere
+            static void round(const Packet &a, Packet &result) { result = std::nearbyint(a); }
+            static void ldexp(const Packet &a, const Packet &n, Packet &result) { result = std::ldexp(a, static_cast<int>(n)); }    ///< a * 2^n for integral n
+        };
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__AVX512F__)
+        template <>
+        struct MathPacket<double, Isa::AVX512>: SimdPacket<double, Isa::AVX512> {
+            NEURAL_TARGET_AVX512 static void add(const Packet &a, const Packet &b, Packet &result) { result = _mm512_add_pd(a, b); }
+            NEURAL_TARGET_AVX512 static void sub(const Packet &a, const Packet &b, Packet &result) { result = _mm512_sub_pd(a, b); }
+            NEURAL_TARGET_AVX512 static void mul(const Packet &a, const Packet &b, Packet &result) { result = _mm512_mul_pd(a, b); }
+            NEURAL_TARGET_AVX512 static void div(const Packet &a, const Packet &b, Packet &result) { result = _mm512_div_pd(a, b); }
+            NEURAL_TARGET_AVX512 static void min(const Packet &a, const Packet &b, Packet &result) { result = _mm512_maskz_min_pd(0xFF, a, b); }
+            NEURAL_TARGET_AVX512 static void abs(const Packet &a, Packet &result) { result = _mm512_abs_pd(a); }
+            NEURAL_TARGET_AVX512 static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) {
+                result = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ), otherwise, less);
+            }
+            NEURAL_TARGET_AVX512 static void round(const Packet &a, Packet &result) { result = _mm512_maskz_roundscale_pd(0xFF, a, _MM_FROUND_TO_NEAREST_INT); }
+            NEURAL_TARGET_AVX512 static void ldexp(const Packet &a, const Packet &n, Packet &result) { result = _mm512_maskz_scalef_pd(0xFF, a, n); }
+        };
+
+        template <>
+        struct MathPacket<float, Isa::AVX512>: SimdPacket<float, Isa::AVX512> {
+            NEURAL_TARGET_AVX512 static void add(const Packet &a, const Packet &b, Packet &result) { result = _mm512_add_ps(a, b); }
+            NEURAL_TARGET_AVX512 static void sub(const Packet &a, const Packet &b, Packet &result) { result = _mm512_sub_ps(a, b); }
+            NEURAL_TARGET_AVX512 static void mul(const Packet &a, const Packet &b, Packet &result) { result = _mm512_mul_ps(a, b); }
+            NEURAL_TARGET_AVX512 static void div(const Packet &a, const Packet &b, Packet &result) { result = _mm512_div_ps(a, b); }
+            NEURAL_TARGET_AVX512 static void min(const Packet &a, const Packet &b, Packet &result) { result = _mm512_maskz_min_ps(0xFFFF, a, b); }
+            NEURAL_TARGET_AVX512 static void abs(const Packet &a, Packet &result) { result = _mm512_abs_ps(a); }
+            NEURAL_TARGET_AVX512 static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) {
+                result = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), otherwise, less);
+            }
+            NEURAL_TARGET_AVX512 static void round(const Packet &a, Packet &result) { result = _mm512_maskz_roundscale_ps(0xFFFF, a, _MM_FROUND_TO_NEAREST_INT); }
+            NEURAL_TARGET_AVX512 static void ldexp(const Packet &a, const Packet &n, Packet &result) { result = _mm512_maskz_scalef_ps(0xFFFF, a, n); }
+        };
+
+        template <typename Scalar>
+        struct MathPacket<Scalar, Isa::AVX512VNNI>: MathPacket<Scalar, Isa::AVX512> {};
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || (defined(__AVX2__) && defined(__FMA__))
+        template <>
+        struct MathPacket<double, Isa::AVX2>: SimdPacket<double, Isa::AVX2> {
+            NEURAL_TARGET_AVX2 static void add(const Packet &a, const Packet &b, Packet &result) { result = _mm256_add_pd(a, b); }
+            NEURAL_TARGET_AVX2 static void sub(const Packet &a, const Packet &b, Packet &result) { result = _mm256_sub_pd(a, b); }
+            NEURAL_TARGET_AVX2 static void mul(const Packet &a, const Packet &b, Packet &result) { result = _mm256_mul_pd(a, b); }
+            NEURAL_TARGET_AVX2 static void div(const Packet &a, const Packet &b, Packet &result) { result = _mm256_div_pd(a, b); }
+            NEURAL_TARGET_AVX2 static void min(const Packet &a, const Packet &b, Packet &result) { result = _mm256_min_pd(a, b); }
+            NEURAL_TARGET_AVX2 static void abs(const Packet &a, Packet &result) { result = _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+            NEURAL_TARGET_AVX2 static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) {
+                result = _mm256_blendv_pd(otherwise, less, _mm256_cmp_pd(a, b, _CMP_LT_OQ));
+            }
+            NEURAL_TARGET_AVX2 static void round(const Packet &a, Packet &result) { result = _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+            NEURAL_TARGET_AVX2 static void ldexp(const Packet &a, const Packet &n, Packet &result) {
+                // Build 2^n by moving the biased exponent into the exponent bits of every double
+                const __m256i exponent = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)), _mm256_set1_epi64x(1023));
+                result = _mm256_mul_pd(a, _mm256_castsi256_pd(_mm256_slli_epi64(exponent, 52)));
+            }
+        };
+
+        template <>
+        struct MathPacket<float, Isa::AVX2>: SimdPacket<float, Isa::AVX2> {
+            NEURAL_TARGET_AVX2 static void add(const Packet &a, const Packet &b, Packet &result) { result = _mm256_add_ps(a, b); }
+            NEURAL_TARGET_AVX2 static void sub(const Packet &a, const Packet &b, Packet &result) { result = _mm256_sub_ps(a, b); }
+            NEURAL_TARGET_AVX2 static void mul(const Packet &a, const Packet &b, Packet &result) { result = _mm256_mul_ps(a, b); }
+            NEURAL_TARGET_AVX2 static void div(const Packet &a, const Packet &b, Packet &result) { result = _mm256_div_ps(a, b); }
+            NEURAL_TARGET_AVX2 static void min(const Packet &a, const Packet &b, Packet &result) { result = _mm256_min_ps(a, b); }
+            NEURAL_TARGET_AVX2 static void abs(const Packet &a, Packet &result) { result = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+            NEURAL_TARGET_AVX2 static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) {
+                result = _mm256_blendv_ps(otherwise, less, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+            }
+            NEURAL_TARGET_AVX2 static void round(const Packet &a, Packet &result) { result = _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+            NEURAL_TARGET_AVX2 static void ldexp(const Packet &a, const Packet &n, Packet &result) {
+                const __m256i exponent = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+                result = _mm256_mul_ps(a, _mm256_castsi256_ps(_mm256_slli_epi32(exponent, 23)));
+            }
+        };
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__SSE2__)
+        template <>
+        struct MathPacket<double, Isa::SSE2>: SimdPacket<double, Isa::SSE2> {
+            static void add(const Packet &a, const Packet &b, Packet &result) { result = _mm_add_pd(a, b); }
+            static void sub(const Packet &a, const Packet &b, Packet &result) { result = _mm_sub_pd(a, b); }
+            static void mul(const Packet &a, const Packet &b, Packet &result) { result = _mm_mul_pd(a, b); }
+            static void div(const Packet &a, const Packet &b, Packet &result) { result = _mm_div_pd(a, b); }
+            static void min(const Packet &a, const Packet &b, Packet &result) { result = _mm_min_pd(a, b); }
+            static void abs(const Packet &a, Packet &result) { result = _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+            static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) {
+                // SSE2 has no blend, so the lanes are combined using the comparison mask
+                const __m128d mask = _mm_cmplt_pd(a, b);
+                result = _mm_or_pd(_mm_and_pd(mask, less), _mm_andnot_pd(mask, otherwise));
+            }
+            static void round(const Packet &a, Packet &result) { result = _mm_cvtepi32_pd(_mm_cvtpd_epi32(a)); }
+            static void ldexp(const Packet &a, const Packet &n, Packet &result) {
+                // Spread the two 32 bit exponents over the 64 bit lanes, where the upper copy is shifted out
+                const __m128i exponent = _mm_add_epi32(_mm_shuffle_epi32(_mm_cvtpd_epi32(n), _MM_SHUFFLE(1, 1, 0, 0)), _mm_set1_epi32(1023));
+                result = _mm_mul_pd(a, _mm_castsi128_pd(_mm_slli_epi64(exponent, 52)));
+            }
+        };
+
+        template <>
+        struct MathPacket<float, Isa::SSE2>: SimdPacket<float, Isa::SSE2> {
+            static void add(const Packet &a, const Packet &b, Packet &result) { result = _mm_add_ps(a, b); }
+            static void sub(const Packet &a, const Packet &b, Packet &result) { result = _mm_sub_ps(a, b); }
+            static void mul(const Packet &a, const Packet &b, Packet &result) { result = _mm_mul_ps(a, b); }
+            static void div(const Packet &a, const Packet &b, Packet &result) { result = _mm_div_ps(a, b); }
+            static void min(const Packet &a, const Packet &b, Packet &result) { result = _mm_min_ps(a, b); }
+            static void abs(const Packet &a, Packet &result) { result = _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+            static void selectLess(const Packet &a, const Packet &b, const Packet &less, const Packet &otherwise, Packet &result) {
+                const __m128 mask = _mm_cmplt_ps(a, b);
+                result = _mm_or_ps(_mm_and_ps(mask, less), _mm_andnot_ps(mask, otherwise));
+            }
+            static void round(const Packet &a, Packet &result) { result = _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+            static void ldexp(const Packet &a, const Packet &n, Packet &result) {
+                const __m128i exponent = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+                result = _mm_mul_ps(a, _mm_castsi128_ps(_mm_slli_epi32(exponent, 23)));
+            }
+        };
+#endif
+
+        /**
+         * @brief Constants of the range reduction of exp for a scalar type
+         */
+        template <typename Scalar>
+        struct ExpConstants {
+            static constexpr double MinArgument = -708;                 ///< Arguments are clamped so 2^n stays normal
+            static constexpr double MaxArgument = 709;
+            static constexpr double Ln2Hi = 6.93145751953125e-1;        ///< log(2) split in two, so n * Ln2Hi is exact
+            static constexpr double Ln2Lo = 1.42860682030941723212e-6;
+        };
+
+        template <>
+        struct ExpConstants<float> {
+            static constexpr double MinArgument = -87;
+            static constexpr double MaxArgument = 88;
+            static constexpr double Ln2Hi = 0.693359375;
+            static constexpr double Ln2Lo = -2.12194440e-4;
+        };
+
+        /**
+         * @brief Approximate exp on a packet
+         * @tparam P The packet operations
+         * @tparam Accuracy The accuracy policy, which selects the degree of the polynomial
+         * @tparam Scalar The scalar type
+         * @param x The packet of arguments
+         * @param y [out]: The packet of exponentials, which may be x
+         */
+        template <typename P, typename Accuracy, typename Scalar>
+        inline void expPacket(const typename P::Packet &x, typename P::Packet &y) {
+            using Packet = typename P::Packet;
+            using Constants = ExpConstants<Scalar>;
+            // Taylor coefficients 1 / k!, whose truncation error on |r| <= log(2) / 2 bounds the error of the policy
+            static const Scalar coefficients[] = {Scalar(1), Scalar(1), Scalar(1.0 / 2), Scalar(1.0 / 6), Scalar(1.0 / 24),
+                                                  Scalar(1.0 / 120), Scalar(1.0 / 720)};
+            static_assert(Accuracy::ExpDegree < sizeof(coefficients) / sizeof(coefficients[0]), "Unsupported degree");
+
+            Packet bound, clamped;
+            P::broadcast(Scalar(Constants::MinArgument), bound);
+            P::max(x, bound, clamped);
+            P::broadcast(Scalar(Constants::MaxArgument), bound);
+            P::min(clamped, bound, clamped);
+
+            Packet constant, n, r;
+            P::broadcast(Scalar(1.44269504088896340736), constant);
+            P::mul(clamped, constant, n);
+            P::round(n, n);
+            P::broadcast(Scalar(-Constants::Ln2Hi), constant);
+            P::fmadd(n, constant, clamped, r);
+            P::broadcast(Scalar(-Constants::Ln2Lo), constant);
+            P::fmadd(n, constant, r, r);
+
+            Packet p;
+            P::broadcast(coefficients[Accuracy::ExpDegree], p);
+            for (int k = Accuracy::ExpDegree - 1; k >= 0; k--) {
+                P::broadcast(coefficients[k], constant);
+                P::fmadd(p, r, constant, p);
+            }
+            P::ldexp(p, n, y);
+        }
+
+        /**
+         * @brief exp(x)
+         */
+        struct ExpFunction {
+            template <typename P, typename Accuracy, typename Scalar>
+            static void apply(const typename P::Packet &x, typename P::Packet &y) {
+                expPacket<P, Accuracy, Scalar>(x, y);
+            }
+
+            template <typename Expr>
+            static auto exact(const Expr &x) -> decltype(x.exp()) {
+                return x.exp();
+            }
+        };
+
+        /**
+         * @brief tanh(x), approximated as (1 - exp(-2x)) / (1 + exp(-2x)), which saturates to -1 and 1 through the
+         *        clamping of the exponential. Below |x| = 1/4, where the numerator cancels, it is approximated as
+         *        x * p(x^2) using the Taylor series of tanh, which keeps the error relative all the way down to zero
+         */
+        struct TanhFunction {
+            template <typename P, typename Accuracy, typename Scalar>
+            static void apply(const typename P::Packet &x, typename P::Packet &y) {
+                // Taylor coefficients of tanh(x) / x in x^2, whose truncation error on |x| < 1/4 bounds the error of the policy
+                static const Scalar coefficients[] = {Scalar(1), Scalar(-1.0 / 3), Scalar(2.0 / 15), Scalar(-17.0 / 315),
+                                                      Scalar(62.0 / 2835), Scalar(-1382.0 / 155925)};
+                static_assert(Accuracy::TanhDegree < sizeof(coefficients) / sizeof(coefficients[0]), "Unsupported degree");
+
+                typename P::Packet x2, p, constant, small;
+                P::mul(x, x, x2);
+                P::broadcast(coefficients[Accuracy::TanhDegree], p);
+                for (int k = Accuracy::TanhDegree - 1; k >= 0; k--) {
+                    P::broadcast(coefficients[k], constant);
+                    P::fmadd(p, x2, constant, p);
+                }
+                P::mul(x, p, small);
+
+                typename P::Packet e, one, numerator, magnitude;
+                P::broadcast(Scalar(-2), e);
+                P::mul(x, e, e);
+                expPacket<P, Accuracy, Scalar>(e, e);
+                P::broadcast(Scalar(1), one);
+                P::sub(one, e, numerator);
+                P::add(one, e, e);
+                P::div(numerator, e, e);
+
+                P::abs(x, magnitude);
+                P::broadcast(Scalar(0.25), constant);
+                P::selectLess(magnitude, constant, small, e, y);
+            }
+
+            template <typename Expr>
+            static auto exact(const Expr &x) -> decltype(activation::Tanh::apply(x)) {
+                return activation::Tanh::apply(x);
+            }
+        };
+
+        /**
+         * @brief sigmoid(x), approximated as 1 / (1 + exp(-x))
+         */
+        struct SigmoidFunction {
+            template <typename P, typename Accuracy, typename Scalar>
+            static void apply(const typename P::Packet &x, typename P::Packet &y) {
+                typename P::Packet e, one;
+                P::zero(e);
+                P::sub(e, x, e);
+                expPacket<P, Accuracy, Scalar>(e, e);
+                P::broadcast(Scalar(1), one);
+                P::add(one, e, e);
+                P::div(one, e, y);
+            }
+
+            template <typename Expr>
+            static auto exact(const Expr &x) -> decltype(activation::Sigmoid::apply(x)) {
+                return activation::Sigmoid::apply(x);
+            }
+        };
+
+        /**
+         * @brief Apply an approximated function to a buffer, one packet at a time. The remainder that doesn't fill a
+         *        whole packet is padded into a packet as well, so narrow layers are vectorized too
+         * @tparam Function The function (ExpFunction, TanhFunction or SigmoidFunction)
+         * @tparam Accuracy The accuracy policy
+         * @tparam I The instruction set
+         * @param x The arguments
+         * @param size The number of arguments
+         * @param y The results, which may be the same buffer as x
+         */
+        template <typename Function, typename Accuracy, Isa I, typename Scalar>
+        void approximate(const Scalar *x, std::size_t size, Scalar *y) {
+            using P = MathPacket<Scalar, I>;
+            typename P::Packet packet;
+            std::size_t i = 0;
+            for (const std::size_t vectorized = size - size % P::Lanes; i < vectorized; i += P::Lanes) {
+                P::load(x + i, packet);
+                Function::template apply<P, Accuracy, Scalar>(packet, packet);
+                P::store(y + i, packet);
+            }
+            if (i < size) {
+                Scalar padded[P::Lanes] = {};
+                std::copy(x + i, x + size, padded);
+                P::load(padded, packet);
+                Function::template apply<P, Accuracy, Scalar>(packet, packet);
+                P::store(padded, packet);
+                std::copy(padded, padded + (size - i), y + i);
+            }
+        }
+
+        /**
+         * @brief Kernel functor of approximate(), run through dispatch()
+         */
+        template <typename Function, typename Accuracy, typename Scalar>
+        struct Approximate {
+            const Scalar *x;
+            std::size_t size;
+            Scalar *y;
+
+            template <Isa I>
+            void operator()(IsaTag<I>) const {
+                approximate<Function, Accuracy, I>(x, size, y);
+            }
+        };
+
+        /**
+         * @brief Apply a function to a buffer exactly using Eigen
+         */
+        template <typename Function, typename Accuracy, typename Scalar>
+        void applyFunction(const Scalar *x, std::size_t size, Scalar *y, std::true_type /*exact*/) {
+            using Array = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+            Eigen::Map<Array>(y, size) = Function::exact(Eigen::Map<const Array>(x, size));
+        }
+
+        /**
+         * @brief Apply a function to a buffer using the approximation of the widest instruction set supported by the CPU
+         */
+        template <typename Function, typename Accuracy, typename Scalar>
+        void applyFunction(const Scalar *x, std::size_t size, Scalar *y, std::false_type /*exact*/) {
+            dispatch<Isa::AVX512>(Approximate<Function, Accuracy, Scalar>{x, size, y});
+        }
+    }
+
+    /**
+     * @brief Compute y = exp(x) on a buffer with an accuracy policy
+     * @tparam Accuracy The accuracy policy (see accuracy::Exact, accuracy::High and accuracy::Low)
+     * @param x The arguments
+     * @param size The number of arguments
+     * @param y The results, which may be the same buffer as x
+     */
+    template <typename Accuracy, typename Scalar>
+    void applyExp(const Scalar *x, std::size_t size, Scalar *y) {
+        detail::applyFunction<detail::ExpFunction, Accuracy>(x, size, y, std::is_same<Accuracy, accuracy::Exact>());
+    }
+
+    /**
+     * @brief Compute y = tanh(x) on a buffer with an accuracy policy
+     * @tparam Accuracy The accuracy policy (see accuracy::Exact, accuracy::High and accuracy::Low)
+     * @param x The arguments
+     * @param size The number of arguments
+     * @param y The results, which may be the same buffer as x
+     */
+    template <typename Accuracy, typename Scalar>
+    void applyTanh(const Scalar *x, std::size_t size, Scalar *y) {
+        detail::applyFunction<detail::TanhFunction, Accuracy>(x, size, y, std::is_same<Accuracy, accuracy::Exact>());
+    }
+
+    /**
+     * @brief Compute y = 1 / (1 + exp(-x)) on a buffer with an accuracy policy
+     * @tparam Accuracy The accuracy policy (see accuracy::Exact, accuracy::High and accuracy::Low)
+     * @param x The arguments
+     * @param size The number of arguments
+     * @param y The results, which may be the same buffer as x
+     */
+    template <typename Accuracy, typename Scalar>
+    void applySigmoid(const Scalar *x, std::size_t size, Scalar *y) {
+        detail::applyFunction<detail::SigmoidFunction, Accuracy>(x, size, y, std::is_same<Accuracy, accuracy::Exact>());
+    }
+}
+
+#endif //NEURAL_FASTMATH_HPP
@@ -0,0 +1,922 @@
+/**
+* \file Gemm.hpp
+*
+* \brief Matrix-matrix product with register-tiled microkernels specialized on compile-time matrix sizes
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_GEMM_HPP
+#define NEURAL_GEMM_HPP
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include <Eigen/Core>
+#include <neural/util/Activation.hpp>
+#include <neural/util/Cpu.hpp>
+#include <neural/util/Storage.hpp>
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// The microkernels rely on their tile loops being fully unrolled, so the accumulators are kept in registers
+#if defined(__clang__)
+#define NEURAL_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define NEURAL_UNROLL _Pragma("GCC unroll 32")
+#else
+#define NEURAL_UNROLL
+#endif
+
+namespace neural {
+    /**
+     * @brief The bias and activation of a layer, which the matrix product kernels apply to the tiles of C = A * B while
+     *        they are still in registers. The bias initializes the accumulators of the first depth block, and the
+     *        activation is applied right before the tiles of the last depth block are stored
+     * @tparam Scalar The scalar type
+     * @tparam Activation The activation function (see Activation.hpp)
+     */
+    template <typename Scalar, typename Activation = activation::Identity>
+    struct Epilogue {
+        const Scalar *bias;     ///< The biases added to every column of C, or nullptr for no bias
+
+        /**
+         * @brief Get the epilogue of the columns of C from a given column on
+         * @param j The first column
+         * @return The epilogue
+         */
+        Epilogue columns(unsigned int j) const {
+            return Epilogue{bias != nullptr ? bias + j : nullptr};
+        }
+    };
+
+    namespace detail {
+        /**
+         * @brief Scalar implementation of the packet operations used by the GEMM microkernels. This is used for
+         *        scalar types without a SIMD implementation, and for rows that don't fill a whole packet
+         * Packets are passed to and from the operations by reference, never by value. The operations of wider
+         * instruction sets are compiled with target attributes while the kernels calling them are not, and vectors
+         * passed in registers between such functions are only correct if every call is inlined (see Cpu.hpp)
+         * @tparam Scalar The scalar type
+         */
+        template <typename Scalar>
+        struct ScalarPacket {
+            using Packet = Scalar;
+            enum {
+                Lanes = 1,          ///< The number of scalars in a packet
+                Registers = 16      ///< The number of registers available for accumulators and operands
+            };
+
+            static const char* name() { return "scalar"; }
+            static void zero(Packet &v) { v = Scalar(0); }
+            static void load(const Scalar *p, Packet &v) { v = *p; }
+            static void broadcast(Scalar s, Packet &v) { v = s; }
+            static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = a * b + c; }
+            static void max(const Packet &a, const Packet &b, Packet &result) { result = std::max(a, b); }
+            static void store(Scalar *p, const Packet &v) { *p = v; }
+            static Scalar sum(const Packet &v) { return v; }
+        };
+
+        /**
+         * @brief Packet operations of an instruction set (AVX-512, AVX2+FMA or SSE2), falling back to ScalarPacket. The
+         *        operations of instruction sets above the one enabled at compile time are compiled using target
+         *        attributes, and must only be used by kernels run through dispatch()
+         * @tparam Scalar The scalar type
+         * @tparam I The instruction set, by default the widest one enabled at compile time
+         */
+        template <typename Scalar, Isa I = NativeIsa>
+        struct SimdPacket: ScalarPacket<Scalar> {};
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__AVX512F__)
+        template <>
+        struct SimdPacket<double, Isa::AVX512> {
+            using Packet = __m512d;
+            enum { Lanes = 8, Registers = 32 };
+
+            static const char* name() { return "AVX-512"; }
+            NEURAL_TARGET_AVX512 static void zero(Packet &v) { v = _mm512_setzero_pd(); }
+            NEURAL_TARGET_AVX512 static void load(const double *p, Packet &v) { v = _mm512_loadu_pd(p); }
+            NEURAL_TARGET_AVX512 static void broadcast(double s, Packet &v) { v = _mm512_set1_pd(s); }
+            NEURAL_TARGET_AVX512 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm512_fmadd_pd(a, b, c); }
+            NEURAL_TARGET_AVX512 static void max(const Packet &a, const Packet &b, Packet &result) { result = _mm512_maskz_max_pd(0xFF, a, b); }
+            NEURAL_TARGET_AVX512 static void store(double *p, const Packet &v) { _mm512_storeu_pd(p, v); }
+            NEURAL_TARGET_AVX512 static double sum(const Packet &v) {
+                // Masked extracts, as the unmasked ones merge into an undefined vector that GCC warns about
+                const __m256d half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, v, 0), _mm512_maskz_extractf64x4_pd(0xF, v, 1));
+                const __m128d quarter = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(quarter, _mm_unpackhi_pd(quarter, quarter)));
+            }
+        };
+
+        template <>
+        struct SimdPacket<float, Isa::AVX512> {
+            using Packet = __m512;
+            enum { Lanes = 16, Registers = 32 };
+
+            static const char* name() { return "AVX-512"; }
+            NEURAL_TARGET_AVX512 static void zero(Packet &v) { v = _mm512_setzero_ps(); }
+            NEURAL_TARGET_AVX512 static void load(const float *p, Packet &v) { v = _mm512_loadu_ps(p); }
+            NEURAL_TARGET_AVX512 static void broadcast(float s, Packet &v) { v = _mm512_set1_ps(s); }
+            NEURAL_TARGET_AVX512 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm512_fmadd_ps(a, b, c); }
+            NEURAL_TARGET_AVX512 static void max(const Packet &a, const Packet &b, Packet &result) { result = _mm512_maskz_max_ps(0xFFFF, a, b); }
+            NEURAL_TARGET_AVX512 static void store(float *p, const Packet &v) { _mm512_storeu_ps(p, v); }
+            NEURAL_TARGET_AVX512 static float sum(const Packet &v) {
+                const __m128 half = _mm_add_ps(_mm_add_ps(_mm512_maskz_extractf32x4_ps(0xF, v, 0), _mm512_maskz_extractf32x4_ps(0xF, v, 1)),
+                                               _mm_add_ps(_mm512_maskz_extractf32x4_ps(0xF, v, 2), _mm512_maskz_extractf32x4_ps(0xF, v, 3)));
+                const __m128 quarter = _mm_add_ps(half, _mm_movehl_ps(half, half));
+                return _mm_cvtss_f32(_mm_add_ss(quarter, _mm_shuffle_ps(quarter, quarter, 1)));
+            }
+        };
+
+        /// AVX-512 VNNI adds no floating point instructions
+        template <typename Scalar>
+        struct SimdPacket<Scalar, Isa::AVX512VNNI>: SimdPacket<Scalar, Isa::AVX512> {};
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || (defined(__AVX2__) && defined(__FMA__))
+        template <>
+        struct SimdPacket<double, Isa::AVX2> {
+            using Packet = __m256d;
+            enum { Lanes = 4, Registers = 16 };
+
+            static const char* name() { return "AVX2"; }
+            NEURAL_TARGET_AVX2 static void zero(Packet &v) { v = _mm256_setzero_pd(); }
+            NEURAL_TARGET_AVX2 static void load(const double *p, Packet &v) { v = _mm256_loadu_pd(p); }
+            NEURAL_TARGET_AVX2 static void broadcast(double s, Packet &v) { v = _mm256_set1_pd(s); }
+            NEURAL_TARGET_AVX2 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm256_fmadd_pd(a, b, c); }
+            NEURAL_TARGET_AVX2 static void max(const Packet &a, const Packet &b, Packet &result) { result = _mm256_max_pd(a, b); }
+            NEURAL_TARGET_AVX2 static void store(double *p, const Packet &v) { _mm256_storeu_pd(p, v); }
+            NEURAL_TARGET_AVX2 static double sum(const Packet &v) {
+                const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+            }
+        };
+
+        template <>
+        struct SimdPacket<float, Isa::AVX2> {
+            using Packet = __m256;
+            enum { Lanes = 8, Registers = 16 };
+
+            static const char* name() { return "AVX2"; }
+            NEURAL_TARGET_AVX2 static void zero(Packet &v) { v = _mm256_setzero_ps(); }
+            NEURAL_TARGET_AVX2 static void load(const float *p, Packet &v) { v = _mm256_loadu_ps(p); }
+            NEURAL_TARGET_AVX2 static void broadcast(float s, Packet &v) { v = _mm256_set1_ps(s); }
+            NEURAL_TARGET_AVX2 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm256_fmadd_ps(a, b, c); }
+            NEURAL_TARGET_AVX2 static void max(const Packet &a, const Packet &b, Packet &result) { result = _mm256_max_ps(a, b); }
+            NEURAL_TARGET_AVX2 static void store(float *p, const Packet &v) { _mm256_storeu_ps(p, v); }
+            NEURAL_TARGET_AVX2 static float sum(const Packet &v) {
+                const __m128 half = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+                const __m128 quarter = _mm_add_ps(half, _mm_movehl_ps(half, half));
+                return _mm_cvtss_f32(_mm_add_ss(quarter, _mm_shuffle_ps(quarter, quarter, 1)));
+            }
+        };
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__SSE2__)
+        template <>
+        struct SimdPacket<double, Isa::SSE2> {
+            using Packet = __m128d;
+            enum { Lanes = 2, Registers = 16 };
+
+            static const char* name() { return "SSE2"; }
+            static void zero(Packet &v) { v = _mm_setzero_pd(); }
+            static void load(const double *p, Packet &v) { v = _mm_loadu_pd(p); }
+            static void broadcast(double s, Packet &v) { v = _mm_set1_pd(s); }
+            static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm_add_pd(_mm_mul_pd(a, b), c); }
+            static void max(const Packet &a, const Packet &b, Packet &result) { result = _mm_max_pd(a, b); }
+            static void store(double *p, const Packet &v) { _mm_storeu_pd(p, v); }
+            static double sum(const Packet &v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+        };
+
+        template <>
+        struct SimdPacket<float, Isa::SSE2> {
+            using Packet = __m128;
+            enum { Lanes = 4, Registers = 16 };
+
+            static const char* name() { return "SSE2"; }
+            static void zero(Packet &v) { v = _mm_setzero_ps(); }
+            static void load(const float *p, Packet &v) { v = _mm_loadu_ps(p); }
+            static void broadcast(float s, Packet &v) { v = _mm_set1_ps(s); }
+            static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm_add_ps(_mm_mul_ps(a, b), c); }
+            static void max(const Packet &a, const Packet &b, Packet &result) { result = _mm_max_ps(a, b); }
+            static void store(float *p, const Packet &v) { _mm_storeu_ps(p, v); }
+            static float sum(const Packet &v) {
+                const __m128 half = _mm_add_ps(v, _mm_movehl_ps(v, v));
+                return _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+            }
+        };
+#endif
+
+        /**
+         * @brief Packet operations at half the width of SimdPacket, for rows that don't fill a whole SimdPacket
+         * @tparam Scalar The scalar type
+         * @tparam I The instruction set, by default the widest one enabled at compile time
+         */
+        template <typename Scalar, Isa I = NativeIsa>
+        struct HalfSimdPacket: ScalarPacket<Scalar> {};
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__AVX512F__)
+        template <>
+        struct HalfSimdPacket<double, Isa::AVX512> {
+            using Packet = __m256d;
+            enum { Lanes = 4, Registers = 32 };
+
+            static const char* name() { return "AVX-512/2"; }
+            NEURAL_TARGET_AVX2 static void zero(Packet &v) { v = _mm256_setzero_pd(); }
+            NEURAL_TARGET_AVX2 static void load(const double *p, Packet &v) { v = _mm256_loadu_pd(p); }
+            NEURAL_TARGET_AVX2 static void broadcast(double s, Packet &v) { v = _mm256_set1_pd(s); }
+            NEURAL_TARGET_AVX2 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm256_fmadd_pd(a, b, c); }
+            NEURAL_TARGET_AVX2 static void store(double *p, const Packet &v) { _mm256_storeu_pd(p, v); }
+            NEURAL_TARGET_AVX2 static double sum(const Packet &v) {
+                const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+                return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+            }
+        };
+
+        template <>
+        struct HalfSimdPacket<float, Isa::AVX512> {
+            using Packet = __m256;
+            enum { Lanes = 8, Registers = 32 };
+
+            static const char* name() { return "AVX-512/2"; }
+            NEURAL_TARGET_AVX2 static void zero(Packet &v) { v = _mm256_setzero_ps(); }
+            NEURAL_TARGET_AVX2 static void load(const float *p, Packet &v) { v = _mm256_loadu_ps(p); }
+            NEURAL_TARGET_AVX2 static void broadcast(float s, Packet &v) { v = _mm256_set1_ps(s); }
+            NEURAL_TARGET_AVX2 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm256_fmadd_ps(a, b, c); }
+            NEURAL_TARGET_AVX2 static void store(float *p, const Packet &v) { _mm256_storeu_ps(p, v); }
+            NEURAL_TARGET_AVX2 static float sum(const Packet &v) {
+                const __m128 half = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+                const __m128 quarter = _mm_add_ps(half, _mm_movehl_ps(half, half));
+                return _mm_cvtss_f32(_mm_add_ss(quarter, _mm_shuffle_ps(quarter, quarter, 1)));
+            }
+        };
+
+        template <typename Scalar>
+        struct HalfSimdPacket<Scalar, Isa::AVX512VNNI>: HalfSimdPacket<Scalar, Isa::AVX512> {};
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || (defined(__AVX2__) && defined(__FMA__))
+        template <>
+        struct HalfSimdPacket<double, Isa::AVX2> {
+            using Packet = __m128d;
+            enum { Lanes = 2, Registers = 16 };
+
+            static const char* name() { return "AVX2/2"; }
+            NEURAL_TARGET_AVX2 static void zero(Packet &v) { v = _mm_setzero_pd(); }
+            NEURAL_TARGET_AVX2 static void load(const double *p, Packet &v) { v = _mm_loadu_pd(p); }
+            NEURAL_TARGET_AVX2 static void broadcast(double s, Packet &v) { v = _mm_set1_pd(s); }
+            NEURAL_TARGET_AVX2 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm_fmadd_pd(a, b, c); }
+            NEURAL_TARGET_AVX2 static void store(double *p, const Packet &v) { _mm_storeu_pd(p, v); }
+            NEURAL_TARGET_AVX2 static double sum(const Packet &v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+        };
+
+        template <>
+        struct HalfSimdPacket<float, Isa::AVX2> {
+            using Packet = __m128;
+            enum { Lanes = 4, Registers = 16 };
+
+            static const char* name() { return "AVX2/2"; }
+            NEURAL_TARGET_AVX2 static void zero(Packet &v) { v = _mm_setzero_ps(); }
+            NEURAL_TARGET_AVX2 static void load(const float *p, Packet &v) { v = _mm_loadu_ps(p); }
+            NEURAL_TARGET_AVX2 static void broadcast(float s, Packet &v) { v = _mm_set1_ps(s); }
+            NEURAL_TARGET_AVX2 static void fmadd(const Packet &a, const Packet &b, const Packet &c, Packet &result) { result = _mm_fmadd_ps(a, b, c); }
+            NEURAL_TARGET_AVX2 static void store(float *p, const Packet &v) { _mm_storeu_ps(p, v); }
+            NEURAL_TARGET_AVX2 static float sum(const Packet &v) {
+                const __m128 half = _mm_add_ps(v, _mm_movehl_ps(v, v));
+                return _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+            }
+        };
+#endif
+
+        /**
+         * @brief Microkernel computing a RowPackets*Lanes x NR tile of C = A * B, keeping the whole tile in registers
+         * The tile is accumulated as a sum of outer products: every step loads a column segment of A (contiguous, as
+         * all matrices are column-major) and broadcasts one element of B per column of the tile
+         * @tparam P The packet operations to use
+         * @tparam RowPackets The number of packets of rows in the tile
+         * @tparam NR The number of columns in the tile
+         */
+        template <typename P, unsigned int RowPackets, unsigned int NR>
+        struct MicroKernel {
+            /**
+             * @brief Compute a tile of C
+             * @tparam Scalar The scalar type
+             * @param kc The depth of the product
+             * @param a The top left element of the tile rows of A
+             * @param lda The column stride of A
+             * @param b The top left element of the tile columns of B
+             * @param bRowStride The distance between consecutive rows of B
+             * @param bColStride The distance between consecutive columns of B
+             * @param c The top left element of the tile of C
+             * @param ldc The column stride of C
+             * @param accumulate Whether to add to the existing contents of C instead of overwriting it
+             * @param last Whether this is the last depth block, whose tile is activated before it is stored
+             * @param epilogue The epilogue of the tile columns of C
+             */
+            template <typename Scalar, typename Activation>
+            static inline void run(unsigned int kc, const Scalar *a, unsigned int lda,
+                                   const Scalar *b, unsigned int bRowStride, unsigned int bColStride,
+                                   Scalar *c, unsigned int ldc, bool accumulate, bool last,
+                                   const Epilogue<Scalar, Activation> &epilogue) {
+                typename P::Packet acc[RowPackets][NR];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    NEURAL_UNROLL
+                    for (unsigned int r = 0; r < RowPackets; r++) {
+                        if (accumulate) {
+                            P::load(c + j * ldc + r * P::Lanes, acc[r][j]);
+                        } else if (epilogue.bias != nullptr) {
+                            P::broadcast(epilogue.bias[j], acc[r][j]);
+                        } else {
+                            P::zero(acc[r][j]);
+                        }
+                    }
+                }
+
+                for (unsigned int k = 0; k < kc; k++) {
+                    typename P::Packet column[RowPackets];
+                    NEURAL_UNROLL
+                    for (unsigned int r = 0; r < RowPackets; r++) {
+                        P::load(a + k * lda + r * P::Lanes, column[r]);
+                    }
+                    NEURAL_UNROLL
+                    for (unsigned int j = 0; j < NR; j++) {
+                        typename P::Packet element;
+                        P::broadcast(b[k * bRowStride + j * bColStride], element);
+                        NEURAL_UNROLL
+                        for (unsigned int r = 0; r < RowPackets; r++) {
+                            P::fmadd(column[r], element, acc[r][j], acc[r][j]);
+                        }
+                    }
+                }
+
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    NEURAL_UNROLL
+                    for (unsigned int r = 0; r < RowPackets; r++) {
+                        if (last) {
+                            Activation::template applyPacket<P, Scalar>(acc[r][j]);
+                        }
+                        P::store(c + j * ldc + r * P::Lanes, acc[r][j]);
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Compile-time blocking parameters for C = A * B, where A is M x K and B is K x N
+         * @tparam Scalar The scalar type
+         * @tparam M The number of rows of A and C
+         * @tparam K The number of columns of A and rows of B
+         * @tparam N The number of columns of B and C
+         * @tparam I The instruction set of the microkernels
+         */
+        template <typename Scalar, unsigned int M, unsigned int K, unsigned int N, Isa I = NativeIsa>
+        struct GemmConfig {
+            using Packet = SimdPacket<Scalar, I>;
+            enum {
+                Lanes = Packet::Lanes,
+                /// Use two packets of rows per tile when there are enough rows, to hide the latency of the FMAs
+                RowPackets = M >= 2 * Lanes ? 2 : 1,
+                MR = RowPackets * Lanes,
+                /// Fill the register file with accumulators, leaving room for a column of A and a broadcast of B
+                MaxNR = (Packet::Registers - RowPackets - 1) / RowPackets,
+                NR = N < MaxNR ? N : MaxNR,
+                /// Block the depth so a tile's slivers of A and B stay in the L1 cache
+                KC = K < 256 ? K : 256,
+                /// Pack slivers of B into contiguous memory when they are reused by enough row tiles to pay off
+                PackB = M / MR >= 4,
+                /// The microkernels outperform Eigen with 256-bit (or wider) FMA packets and at least a packet of rows
+                Profitable = Lanes * sizeof(Scalar) >= 32 && M >= Lanes
+            };
+        };
+
+        /**
+         * @brief Compute all rows of a column tile of C = A * B, using the widest microkernel that fits the rows
+         * @tparam Scalar The scalar type
+         * @tparam M The number of rows of A and C
+         * @tparam NR The number of columns in the tile
+         * @tparam Config The blocking parameters
+         */
+        template <typename Scalar, unsigned int M, unsigned int NR, typename Config, typename Activation>
+        inline void gemmColumnTile(unsigned int kc, const Scalar *a, const Scalar *b, unsigned int bRowStride,
+                                   unsigned int bColStride, Scalar *c, bool accumulate, bool last,
+                                   const Epilogue<Scalar, Activation> &epilogue) {
+            using Packet = typename Config::Packet;
+            constexpr unsigned int MR = Config::MR;
+            constexpr unsigned int Lanes = Config::Lanes;
+
+            unsigned int i = 0;
+            for (; i + MR <= M; i += MR) {
+                MicroKernel<Packet, Config::RowPackets, NR>::run(kc, a + i, M, b, bRowStride, bColStride, c + i, M, accumulate, last, epilogue);
+            }
+            for (; i + Lanes <= M; i += Lanes) {
+                MicroKernel<Packet, 1, NR>::run(kc, a + i, M, b, bRowStride, bColStride, c + i, M, accumulate, last, epilogue);
+            }
+            for (; i < M; i++) {
+                MicroKernel<ScalarPacket<Scalar>, 1, NR>::run(kc, a + i, M, b, bRowStride, bColStride, c + i, M, accumulate, last, epilogue);
+            }
+        }
+
+        /**
+         * @brief Compute a column tile of C = A * B, packing the tile's sliver of B first if configured to
+         */
+        template <typename Scalar, unsigned int M, unsigned int K, unsigned int NR, typename Config, typename Activation>
+        inline void gemmPanel(unsigned int kc, const Scalar *a, const Scalar *b, Scalar *c, bool accumulate, bool last,
+                              const Epilogue<Scalar, Activation> &epilogue) {
+            if (Config::PackB) {
+                Scalar packed[Config::KC * NR];
+                for (unsigned int k = 0; k < kc; k++) {
+                    for (unsigned int j = 0; j < NR; j++) {
+                        packed[k * NR + j] = b[k + j * K];
+                    }
+                }
+                gemmColumnTile<Scalar, M, NR, Config>(kc, a, packed, NR, 1, c, accumulate, last, epilogue);
+            } else {
+                gemmColumnTile<Scalar, M, NR, Config>(kc, a, b, 1, K, c, accumulate, last, epilogue);
+            }
+        }
+
+        /**
+         * @brief Elements stored at full precision are used in place
+         * @return The elements
+         */
+        template <typename Scalar>
+        inline const Scalar* widen(const Scalar *stored, unsigned int size, Scalar* /*buffer*/) {
+            return stored;
+        }
+
+        /**
+         * @brief Widen elements stored at reduced precision into a buffer (see Storage.hpp)
+         * @param stored The elements to widen
+         * @param size The number of elements
+         * @param buffer [out]: The buffer of at least size elements to widen into
+         * @return The buffer
+         */
+        template <typename Scalar, typename Stored>
+        inline const Scalar* widen(const Stored *stored, unsigned int size, Scalar *buffer) {
+            convert(stored, size, buffer);
+            return buffer;
+        }
+
+        /**
+         * @brief Kernel computing Columns elements of y = x * B for a column-major B, as dot products of x with
+         *        columns of B, which are only summed horizontally once at the end. The bias and activation are applied
+         *        to the dot products before they are stored
+         * @tparam P The packet operations
+         * @tparam Columns The number of elements of y
+         */
+        template <typename P, unsigned int Columns>
+        struct GemvDotKernel {
+            /**
+             * @brief Compute elements of y
+             * @tparam Scalar The scalar type
+             * @param k The number of elements of x and rows of B
+             * @param x The vector x
+             * @param b The first column of B to use
+             * @param ldb The column stride of B
+             * @param y The first element of y to compute
+             * @param epilogue The epilogue of the elements of y
+             */
+            template <typename Scalar, typename Activation>
+            static inline void run(unsigned int k, const Scalar *x, const Scalar *b, unsigned int ldb, Scalar *y,
+                                   const Epilogue<Scalar, Activation> &epilogue) {
+                typename P::Packet acc[Columns];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < Columns; j++) {
+                    P::zero(acc[j]);
+                }
+                unsigned int i = 0;
+                for (; i + P::Lanes <= k; i += P::Lanes) {
+                    typename P::Packet segment;
+                    P::load(x + i, segment);
+                    NEURAL_UNROLL
+                    for (unsigned int j = 0; j < Columns; j++) {
+                        typename P::Packet column;
+                        P::load(b + j * ldb + i, column);
+                        P::fmadd(column, segment, acc[j], acc[j]);
+                    }
+                }
+                Scalar dots[Columns];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < Columns; j++) {
+                    dots[j] = P::sum(acc[j]) + (epilogue.bias != nullptr ? epilogue.bias[j] : Scalar(0));
+                    for (unsigned int r = i; r < k; r++) {
+                        dots[j] += x[r] * b[j * ldb + r];
+                    }
+                }
+                const Eigen::Map<Eigen::Array<Scalar, Columns, 1>> mapped(dots);
+                Eigen::Map<Eigen::Array<Scalar, Columns, 1>> output(y);
+                output = Activation::apply(mapped);
+            }
+        };
+
+        /**
+         * @brief Compute n consecutive elements of y = x * B for a column-major B, several columns at a time
+         */
+        template <unsigned int K, Isa I, typename Scalar, typename Activation>
+        inline void gemvColumns(const Scalar *x, const Scalar *b, unsigned int n, Scalar *y,
+                                const Epilogue<Scalar, Activation> &epilogue) {
+            using P = SimdPacket<Scalar, I>;
+            /// Use more columns, and thus more independent chains of FMAs, when there are enough registers
+            constexpr unsigned int Columns = P::Registers >= 32 ? 8 : 4;
+            unsigned int j = 0;
+            for (; j + Columns <= n; j += Columns) {
+                GemvDotKernel<P, Columns>::run(K, x, b + j * K, K, y + j, epilogue.columns(j));
+            }
+            for (; j + 4 <= n; j += 4) {
+                GemvDotKernel<P, 4>::run(K, x, b + j * K, K, y + j, epilogue.columns(j));
+            }
+            for (; j < n; j++) {
+                GemvDotKernel<P, 1>::run(K, x, b + j * K, K, y + j, epilogue.columns(j));
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the matrix product C = A * B, where A is M x K, B is K x N and C is M x N, all in column-major
+     *        order. Tile sizes, blocking and packing are chosen at compile time from the matrix sizes and the
+     *        instruction set (AVX-512, AVX2+FMA, SSE2 or scalar)
+     * @tparam M The number of rows of A and C
+     * @tparam K The number of columns of A and rows of B
+     * @tparam N The number of columns of B and C
+     * @tparam Scalar The scalar type
+     * @tparam I The instruction set, by default the widest one enabled at compile time. Wider ones must be run
+     *         through detail::dispatch(), as matrixProduct() does
+     * @param a The M x K matrix A
+     * @param b The K x N matrix B
+     * @param c [out]: The M x N matrix C, which must not alias A or B
+     * @param epilogue The bias and activation to apply to C, none by default
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, Isa I = NativeIsa,
+              typename Activation = activation::Identity>
+    void gemm(const Scalar *a, const Scalar *b, Scalar *c,
+              const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        using Config = detail::GemmConfig<Scalar, M, K, N, I>;
+        constexpr unsigned int NR = Config::NR;
+        constexpr unsigned int Remainder = N % NR;
+
+        for (unsigned int pc = 0; pc < K; pc += Config::KC) {
+            const unsigned int kc = K - pc < Config::KC ? K - pc : Config::KC;
+            const bool last = pc + kc == K;
+            const Scalar *aBlock = a + pc * M;
+            const Scalar *bBlock = b + pc;
+
+            unsigned int jc = 0;
+            for (; jc + NR <= N; jc += NR) {
+                detail::gemmPanel<Scalar, M, K, NR, Config>(kc, aBlock, bBlock + jc * K, c + jc * M, pc > 0, last, epilogue.columns(jc));
+            }
+            if (Remainder > 0) {
+                detail::gemmPanel<Scalar, M, K, (Remainder > 0 ? Remainder : 1), Config>(kc, aBlock, bBlock + jc * K, c + jc * M, pc > 0, last, epilogue.columns(jc));
+            }
+        }
+    }
+
+    /**
+     * @brief Rearrange B into the panel layout consumed by the microkernels of gemmPacked(). Every depth block of every
+     *        column tile of B is stored as a contiguous sliver, with the columns of a tile interleaved, so products with a
+     *        constant B neither pack nor stride through it on every call
+     * @tparam M The number of rows of A and C in the products B will be used for (the layout depends on the tiling)
+     * @tparam K The number of rows of B
+     * @tparam N The number of columns of B
+     * @tparam Scalar The scalar type
+     * @tparam Stored The scalar type to store the packed B in (see Storage.hpp)
+     * @tparam I The instruction set of the gemmPacked() the packed B will be used by (the layout depends on the tiling)
+     * @param b The K x N matrix B, in column-major order
+     * @param packed [out]: The K * N elements of B in panel layout
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Stored, Isa I = NativeIsa>
+    void packGemmRhs(const Scalar *b, Stored *packed) {
+        using Config = detail::GemmConfig<Scalar, M, K, N, I>;
+        constexpr unsigned int NR = Config::NR;
+
+        for (unsigned int pc = 0; pc < K; pc += Config::KC) {
+            const unsigned int kc = K - pc < Config::KC ? K - pc : Config::KC;
+            for (unsigned int jc = 0; jc < N; jc += NR) {
+                const unsigned int nr = N - jc < NR ? N - jc : NR;
+                for (unsigned int k = 0; k < kc; k++) {
+                    for (unsigned int j = 0; j < nr; j++) {
+                        *packed++ = static_cast<Stored>(b[(pc + k) + (jc + j) * K]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the matrix product C = A * B like gemm(), where B has been rearranged by packGemmRhs()
+     * @tparam M The number of rows of A and C
+     * @tparam K The number of columns of A and rows of B
+     * @tparam N The number of columns of B and C
+     * @tparam Scalar The scalar type
+     * @tparam Stored The scalar type the packed B is stored in. A reduced precision B is widened to Scalar one
+     *         sliver at a time into a buffer on the stack, which all row tiles then share from the L1 cache. The
+     *         conversion is not fused into the microkernels, so every widened sliver is stored and loaded again
+     *         instead of being converted in registers
+     * @tparam I The instruction set, which must be the one B was packed for (see gemm())
+     * @param a The M x K matrix A, in column-major order
+     * @param packed The K x N matrix B, packed by packGemmRhs()
+     * @param c [out]: The M x N matrix C, in column-major order, which must not alias A or B
+     * @param epilogue The bias and activation to apply to C, none by default
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Stored, Isa I = NativeIsa,
+              typename Activation = activation::Identity>
+    void gemmPacked(const Scalar *a, const Stored *packed, Scalar *c,
+                    const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        using Config = detail::GemmConfig<Scalar, M, K, N, I>;
+        constexpr unsigned int NR = Config::NR;
+        constexpr unsigned int Remainder = N % NR;
+        Scalar widened[std::is_same<Scalar, Stored>::value ? 1 : Config::KC * NR];
+
+        for (unsigned int pc = 0; pc < K; pc += Config::KC) {
+            const unsigned int kc = K - pc < Config::KC ? K - pc : Config::KC;
+            const bool last = pc + kc == K;
+            const Scalar *aBlock = a + pc * M;
+
+            unsigned int jc = 0;
+            for (; jc + NR <= N; jc += NR) {
+                const Scalar *sliver = detail::widen(packed, kc * NR, widened);
+                detail::gemmColumnTile<Scalar, M, NR, Config>(kc, aBlock, sliver, NR, 1, c + jc * M, pc > 0, last, epilogue.columns(jc));
+                packed += kc * NR;
+            }
+            if (Remainder > 0) {
+                const Scalar *sliver = detail::widen(packed, kc * Remainder, widened);
+                detail::gemmColumnTile<Scalar, M, (Remainder > 0 ? Remainder : 1), Config>(kc, aBlock, sliver, Remainder, 1, c + jc * M, pc > 0, last, epilogue.columns(jc));
+                packed += kc * Remainder;
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the vector-matrix product y = x * B, the product of a batch of a single sample, where x has K
+     *        elements, B is K x N in column-major order and y has N elements. Every element of y is a dot product of x
+     *        with a contiguous column of B, and several columns are computed at a time to hide the latency of the FMAs
+     * @tparam K The number of elements of x and rows of B
+     * @tparam N The number of columns of B and elements of y
+     * @tparam Scalar The scalar type
+     * @tparam I The instruction set (see gemm())
+     * @param x The vector x
+     * @param b The K x N matrix B, in column-major order
+     * @param y [out]: The vector y, which must not alias x or B
+     * @param epilogue The bias and activation to apply to y, none by default
+     */
+    template <unsigned int K, unsigned int N, typename Scalar, Isa I = NativeIsa, typename Activation = activation::Identity>
+    void gemv(const Scalar *x, const Scalar *b, Scalar *y,
+              const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        detail::gemvColumns<K, I>(x, b, N, y, epilogue);
+    }
+
+    /**
+     * @brief Compute the vector-matrix product y = x * B like gemv(), where B is stored in a reduced precision type and
+     *        is widened a few columns at a time right before they are used. The columns are widened into a buffer on
+     *        the stack rather than converted in registers, so they are stored and loaded again at full precision
+     * @tparam K The number of elements of x and rows of B
+     * @tparam N The number of columns of B and elements of y
+     * @tparam Scalar The scalar type
+     * @tparam Stored The scalar type B is stored in (see Storage.hpp)
+     * @tparam I The instruction set (see gemm())
+     * @param x The vector x
+     * @param b The K x N matrix B, in column-major order
+     * @param y [out]: The vector y, which must not alias x or B
+     * @param epilogue The bias and activation to apply to y, none by default
+     */
+    template <unsigned int K, unsigned int N, typename Scalar, typename Stored, Isa I = NativeIsa,
+              typename Activation = activation::Identity>
+    void gemv(const Scalar *x, const Stored *b, Scalar *y,
+              const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        /// Widen as many columns at a time as fit in a buffer of 4096 elements, which stays in the L1 cache
+        constexpr unsigned int BlockColumns = K >= 4096 ? 1 : (4096 / K < N ? 4096 / K : N);
+        Scalar widened[BlockColumns * K];
+
+        unsigned int j = 0;
+        for (; j + BlockColumns <= N; j += BlockColumns) {
+            detail::gemvColumns<K, I>(x, detail::widen(b + j * K, BlockColumns * K, widened), BlockColumns, y + j, epilogue.columns(j));
+        }
+        if (j < N) {
+            detail::gemvColumns<K, I>(x, detail::widen(b + j * K, (N - j) * K, widened), N - j, y + j, epilogue.columns(j));
+        }
+    }
+
+    namespace detail {
+        /// Tag selecting the vector-matrix products for a single row of A
+        struct UseGemv {};
+
+        /// The tag selecting the kernels of a product: UseGemv, or whether to use the microkernels instead of Eigen
+        template <typename Scalar, unsigned int M, unsigned int K, unsigned int N, Isa I>
+        using ProductKernels = typename std::conditional<M == 1, UseGemv,
+                std::integral_constant<bool, GemmConfig<Scalar, M, K, N, I>::Profitable>>::type;
+
+        /**
+         * @brief Compute c = a * B using gemv()
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Activation>
+        inline void matrixProduct(const Scalar *a, const Scalar *b, Scalar *c, const Epilogue<Scalar, Activation> &epilogue, UseGemv) {
+            gemv<K, N, Scalar, I>(a, b, c, epilogue);
+        }
+
+        /**
+         * @brief Compute C = A * B using the microkernels
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Activation>
+        inline void matrixProduct(const Scalar *a, const Scalar *b, Scalar *c, const Epilogue<Scalar, Activation> &epilogue,
+                                  std::true_type /*useMicroKernels*/) {
+            gemm<M, K, N, Scalar, I>(a, b, c, epilogue);
+        }
+
+        /**
+         * @brief Compute C = A * B using Eigen's matrix product. Eigen selects its instructions at compile time, so this
+         *        is never inlined into the kernels of a dispatched instruction set. Eigen's product cannot apply the
+         *        epilogue to its tiles, so it is applied in a separate pass over C
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Activation>
+        NEURAL_NOINLINE void matrixProduct(const Scalar *a, const Scalar *b, Scalar *c, const Epilogue<Scalar, Activation> &epilogue,
+                                           std::false_type /*useMicroKernels*/) {
+            using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+            Eigen::Map<Matrix>(c, M, N).noalias() = Eigen::Map<const Matrix>(a, M, K) * Eigen::Map<const Matrix>(b, K, N);
+            applyEpilogue<Activation, M, N>(c, epilogue.bias);
+        }
+
+        /**
+         * @brief Function object computing C = A * B with the kernels of the instruction set it is called with
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Activation = activation::Identity>
+        struct MatrixProduct {
+            const Scalar *a;
+            const Scalar *b;
+            Scalar *c;
+            Epilogue<Scalar, Activation> epilogue;
+
+            template <Isa I>
+            void operator()(IsaTag<I>) const {
+                matrixProduct<M, K, N, I>(a, b, c, epilogue, ProductKernels<Scalar, M, K, N, I>());
+            }
+        };
+    }
+
+    /**
+     * @brief Compute the matrix product C = A * B, all in column-major order, choosing between gemv() for a single row
+     *        of A, and the microkernels of gemm() or Eigen's matrix product depending on which is expected to be
+     *        faster. The kernels use the widest instruction set supported by the CPU (see cpuIsa())
+     * @tparam M The number of rows of A and C
+     * @tparam K The number of columns of A and rows of B
+     * @tparam N The number of columns of B and C
+     * @tparam Scalar The scalar type
+     * @param a The M x K matrix A
+     * @param b The K x N matrix B
+     * @param c [out]: The M x N matrix C, which must not alias A or B
+     * @param epilogue The bias and activation to apply to C while it is written, none by default
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Activation = activation::Identity>
+    void matrixProduct(const Scalar *a, const Scalar *b, Scalar *c,
+                       const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        detail::dispatch<Isa::AVX512>(detail::MatrixProduct<M, K, N, Scalar, Activation>{a, b, c, epilogue});
+    }
+
+    namespace detail {
+        /**
+         * @brief Pack B for gemv(), which uses B in its column-major order
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Stored>
+        inline void packRhs(const Scalar *b, Stored *packed, UseGemv) {
+            convert(b, std::size_t(K) * N, packed);
+        }
+
+        /**
+         * @brief Compute c = a * B using gemv() on a packed B
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Stored, typename Activation>
+        inline void matrixProductPacked(const Scalar *a, const Stored *packed, Scalar *c,
+                                        const Epilogue<Scalar, Activation> &epilogue, UseGemv) {
+            gemv<K, N, Scalar, Stored, I>(a, packed, c, epilogue);
+        }
+
+        /**
+         * @brief Pack B for the microkernels
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Stored>
+        inline void packRhs(const Scalar *b, Stored *packed, std::true_type /*useMicroKernels*/) {
+            packGemmRhs<M, K, N, Scalar, Stored, I>(b, packed);
+        }
+
+        /**
+         * @brief Eigen's matrix product packs B itself, so B is kept in column-major order
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Stored>
+        inline void packRhs(const Scalar *b, Stored *packed, std::false_type /*useMicroKernels*/) {
+            for (unsigned int i = 0; i < K * N; i++) {
+                packed[i] = static_cast<Stored>(b[i]);
+            }
+        }
+
+        /**
+         * @brief Compute C = A * B using the microkernels on a packed B
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Stored, typename Activation>
+        inline void matrixProductPacked(const Scalar *a, const Stored *packed, Scalar *c,
+                                        const Epilogue<Scalar, Activation> &epilogue, std::true_type /*useMicroKernels*/) {
+            gemmPacked<M, K, N, Scalar, Stored, I>(a, packed, c, epilogue);
+        }
+
+        /**
+         * @brief Compute C = A * B using Eigen's matrix product on an unpacked B
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Activation>
+        inline void matrixProductPacked(const Scalar *a, const Scalar *packed, Scalar *c,
+                                        const Epilogue<Scalar, Activation> &epilogue, std::false_type /*useMicroKernels*/) {
+            matrixProduct<M, K, N, I>(a, packed, c, epilogue, std::false_type());
+        }
+
+        /**
+         * @brief Compute C = A * B using Eigen's matrix product on an unpacked B stored at reduced precision. Eigen
+         *        cannot read the stored type, so B is widened a block of columns at a time, small enough to stay cached.
+         *        The epilogue is applied in a separate pass over C
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, typename Stored, typename Activation>
+        NEURAL_NOINLINE void matrixProductPacked(const Scalar *a, const Stored *packed, Scalar *c,
+                                                 const Epilogue<Scalar, Activation> &epilogue, std::false_type /*useMicroKernels*/) {
+            using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+            constexpr unsigned int BlockColumns = K >= 65536 ? 1 : (65536 / K < N ? 65536 / K : N);
+            std::vector<Scalar> widened(K * BlockColumns);
+            const Eigen::Map<const Matrix> mappedA(a, M, K);
+            for (unsigned int j = 0; j < N; j += BlockColumns) {
+                const unsigned int columns = N - j < BlockColumns ? N - j : BlockColumns;
+                widen(packed + j * K, K * columns, widened.data());
+                Eigen::Map<Matrix>(c + j * M, M, columns).noalias() = mappedA * Eigen::Map<const Matrix>(widened.data(), K, columns);
+            }
+            applyEpilogue<Activation, M, N>(c, epilogue.bias);
+        }
+
+        /**
+         * @brief Function object packing B for the kernels of the instruction set it is called with
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Stored>
+        struct PackRhs {
+            const Scalar *b;
+            Stored *packed;
+
+            template <Isa I>
+            void operator()(IsaTag<I>) const {
+                packRhs<M, K, N, I>(b, packed, ProductKernels<Scalar, M, K, N, I>());
+            }
+        };
+
+        /**
+         * @brief Function object computing C = A * B on a packed B with the kernels of the instruction set it is called
+         *        with
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Stored, typename Activation = activation::Identity>
+        struct MatrixProductPacked {
+            const Scalar *a;
+            const Stored *packed;
+            Scalar *c;
+            Epilogue<Scalar, Activation> epilogue;
+
+            template <Isa I>
+            void operator()(IsaTag<I>) const {
+                matrixProductPacked<M, K, N, I>(a, packed, c, epilogue, ProductKernels<Scalar, M, K, N, I>());
+            }
+        };
+    }
+
+    /**
+     * @brief Rearrange B, which is constant across many products, into the layout consumed by matrixProductPacked()
+     * The layout depends on the instruction set the kernels run with, which is fixed for the lifetime of the process
+     * @tparam M The number of rows of A and C in the products B will be used for
+     * @tparam K The number of rows of B
+     * @tparam N The number of columns of B
+     * @tparam Scalar The scalar type
+     * @tparam Stored The scalar type to store the packed B in (see Storage.hpp)
+     * @param b The K x N matrix B, in column-major order
+     * @param packed [out]: The K * N elements of B, in the layout consumed by matrixProductPacked()
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Stored>
+    void packRhs(const Scalar *b, Stored *packed) {
+        detail::dispatch<Isa::AVX512>(detail::PackRhs<M, K, N, Scalar, Stored>{b, packed});
+    }
+
+    /**
+     * @brief Compute the matrix product C = A * B like matrixProduct(), where B has been rearranged by packRhs()
+     * @tparam M The number of rows of A and C
+     * @tparam K The number of columns of A and rows of B
+     * @tparam N The number of columns of B and C
+     * @tparam Scalar The scalar type
+     * @tparam Stored The scalar type the packed B is stored in
+     * @param a The M x K matrix A, in column-major order
+     * @param packed The K x N matrix B, packed by packRhs()
+     * @param c [out]: The M x N matrix C, in column-major order, which must not alias A or B
+     * @param epilogue The bias and activation to apply to C while it is written, none by default
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, typename Stored,
+              typename Activation = activation::Identity>
+    void matrixProductPacked(const Scalar *a, const Stored *packed, Scalar *c,
+                             const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        detail::dispatch<Isa::AVX512>(detail::MatrixProductPacked<M, K, N, Scalar, Stored, Activation>{a, packed, c, epilogue});
+    }
+}
+
+#undef NEURAL_UNROLL
+
+#endif //NEURAL_GEMM_HPP
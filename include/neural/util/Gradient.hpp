@@ -10,8 +10,12 @@
 #ifndef NEURAL_GRADIENT_HPP
 #define NEURAL_GRADIENT_HPP
 
+#include <type_traits>
+
 #ifdef AUTO_DIFF_ENABLED
 #include <stan/math.hpp>
+#include <cstddef>
+#include <stdexcept>
 
 namespace neural {
     using Derivative = stan::math::var;         ///< The scalar type used for training neural networks using auto diff
@@ -27,6 +31,102 @@ namespace neural {
         return derivative.adj();
     }
 
+    /**
+     * Persistent arena for the auto diff tapes of repeated training steps
+     * Every step is recorded in a nested Stan Math scope. Nodes recorded during a step are discarded when it ends, so
+     * resetting the arena only rewinds the Stan Math allocator instead of also walking the tape to zero adjoints. The
+     * allocator keeps its blocks between steps, so once the arena has grown to the size of a step (or has been
+     * pre-sized using reserve()), steady-state training performs no allocator work.
+     */
+    class GradientArena {
+    public:
+        GradientArena() = default;
+
+        /**
+         * @brief Creates a new GradientArena pre-sized to hold steps of a given size
+         * @param bytes The number of bytes to reserve
+         */
+        explicit GradientArena(std::size_t bytes) {
+            reserve(bytes);
+        }
+
+        /**
+         * @brief Grow the underlying allocator so that steps of up to a given size never need to allocate
+         * @param bytes The number of bytes to reserve
+         */
+        void reserve(std::size_t bytes) {
+            stan::math::start_nested();
+            stan::math::ChainableStack::memalloc_.alloc(bytes);
+            stan::math::recover_memory_nested();
+        }
+
+        /**
+         * @brief Start recording a step
+         */
+        void begin() {
+            if (m_recording) {
+                throw std::runtime_error("GradientArena is already recording a step");
+            }
+            stan::math::start_nested();
+            m_nodesAtBegin = stan::math::ChainableStack::var_stack_.size() + stan::math::ChainableStack::var_nochain_stack_.size();
+            m_recording = true;
+        }
+
+        /**
+         * @brief Stop recording a step, discarding everything recorded since begin() while keeping the memory around
+         */
+        void reset() {
+            if (!m_recording) {
+                throw std::runtime_error("GradientArena is not recording a step");
+            }
+            m_nodesUsed = stan::math::ChainableStack::var_stack_.size() + stan::math::ChainableStack::var_nochain_stack_.size() - m_nodesAtBegin;
+            m_bytesUsed = stan::math::ChainableStack::memalloc_.bytes_allocated();
+            if (m_bytesUsed > m_peakBytes) {
+                m_peakBytes = m_bytesUsed;
+                m_numGrowths++;
+            }
+            stan::math::recover_memory_nested();
+            m_recording = false;
+        }
+
+        /**
+         * @return The number of bytes spanned by the arena blocks in use at the end of the last step
+         */
+        std::size_t bytesUsed() const {
+            return m_bytesUsed;
+        }
+
+        /**
+         * @return The largest number of bytes spanned by the arena blocks in use at the end of any step
+         */
+        std::size_t peakBytes() const {
+            return m_peakBytes;
+        }
+
+        /**
+         * @return The number of nodes recorded on the tape during the last step
+         */
+        std::size_t nodesUsed() const {
+            return m_nodesUsed;
+        }
+
+        /**
+         * @return The number of steps that reached further into the arena than any step before. Stan Math does not
+         *         expose its block count, but this only increases when the allocator has to do work
+         */
+        std::size_t numGrowths() const {
+            return m_numGrowths;
+        }
+
+    private:
+        bool m_recording = false;           ///< Whether a step is currently being recorded
+        std::size_t m_nodesAtBegin = 0;     ///< The number of nodes on the tape when the current step began
+        std::size_t m_nodesUsed = 0;        ///< The number of nodes recorded during the last step
+        std::size_t m_bytesUsed = 0;        ///< The number of bytes spanned by the arena blocks in use after the last step
+        std::size_t m_peakBytes = 0;        ///< The largest value of m_bytesUsed seen so far
+        std::size_t m_numGrowths = 0;       ///< The number of times m_peakBytes has increased
+    };
+
     /**
      * RAII wrapper around the Stan Math memory handling functions
      * Stan Math uses an arena allocator internally to handle allocations. Unless recover_memory is called, this arena
@@ -42,13 +142,31 @@ namespace neural {
             stan::math::start_nested();
         }
 
+        /**
+         * @brief Creates a new GradientGuard that records a step in a persistent GradientArena, e.g. from Net::arena()
+         * @param arena The arena to record in
+         */
+        explicit GradientGuard(GradientArena &arena): m_arena(&arena) {
+            m_arena->begin();
+        }
+
+        GradientGuard(const GradientGuard&) = delete;
+        GradientGuard& operator=(const GradientGuard&) = delete;
+
         /**
          * @brief Releases a GradientGuard, causing intermediary neural::Derivative allocations to be reset
          */
         ~GradientGuard() {
+            if (m_arena != nullptr) {
+                m_arena->reset();
+                return;
+            }
             stan::math::set_zero_all_adjoints_nested();
             stan::math::recover_memory_nested();
         }
+
+    private:
+        GradientArena *m_arena = nullptr;   ///< The arena to record in, if any
     };
 }
 
@@ -59,7 +177,45 @@ namespace neural {
 namespace neural {
     using Derivative = void;
     void getGradient();
+    class GradientArena;
 }
 
 #endif //AUTO_DIFF_ENABLED
+
+namespace neural {
+    /**
+     * @brief Maps a layer scalar type to the plain scalar type used for storing values and gradients
+     * @tparam Dtype The layer scalar type
+     */
+    template <typename Dtype>
+    struct ValueType {
+        using type = Dtype;
+    };
+
+#ifdef AUTO_DIFF_ENABLED
+    /**
+     * @brief ValueType specialization for neural::Derivative, which stores its values as neural::BaseType
+     */
+    template <>
+    struct ValueType<Derivative> {
+        using type = BaseType;
+    };
+#endif //AUTO_DIFF_ENABLED
+
+    /**
+     * @brief Whether a scalar type is trained using the native (tensor-level) backpropagation engine, i.e. layers
+     *        compute their gradients analytically instead of relying on auto diff
+     * @tparam Dtype The layer scalar type
+     */
+    template <typename Dtype>
+    struct IsNative: std::is_floating_point<Dtype> {};
+
+    /**
+     * @brief Whether a scalar type supports training, either through auto diff or through native backpropagation
+     * @tparam Dtype The layer scalar type
+     */
+    template <typename Dtype>
+    struct IsTrainable: std::integral_constant<bool, std::is_same<Dtype, Derivative>::value || IsNative<Dtype>::value> {};
+}
+
 #endif //NEURAL_GRADIENT_HPP
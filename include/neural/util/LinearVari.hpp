@@ -0,0 +1,143 @@
+/**
+* \file LinearVari.hpp
+*
+* \brief Stan Math vari that records an entire linear layer, y = xW + b, as a single node on the auto diff tape
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_LINEARVARI_HPP
+#define NEURAL_LINEARVARI_HPP
+
+#ifdef AUTO_DIFF_ENABLED
+#include <neural/util/Gradient.hpp>
+#include <neural/util/Activation.hpp>
+#include <neural/util/Gemm.hpp>
+#include <Eigen/Core>
+
+namespace neural {
+    namespace detail {
+        /**
+         * @brief Stan Math vari that records an entire linear layer, y = f(xW + b), as a single node on the auto diff tape
+         * Letting Stan Math record the layer scalar by scalar results in BatchSize*InputSize*NumNeurons nodes. Instead,
+         * this node evaluates the product using plain doubles and propagates adjoints using two dense matrix products,
+         * dx = dz * W^T and dW = x^T * dz, where dz = dy * f'(y). The outputs are exposed as separate varis that are not
+         * chained themselves.
+         * The weights and biases are not on the tape at all - they are read from, and their gradients accumulated
+         * directly into, the contiguous parameter and gradient buffers owned by the layer, which must outlive the tape.
+         * All other storage is taken from the Stan Math arena, and is released together with the rest of the tape.
+         * @tparam InputSize The number of inputs to the layer
+         * @tparam NumNeurons The number of neurons (outputs)
+         * @tparam BatchSize The batch size to use
+         * @tparam UseBias Whether to include a bias term
+         * @tparam Activation The activation function f fused into the layer (see Activation.hpp)
+         */
+        template <unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias, typename Activation>
+        class LinearVari: public stan::math::vari {
+        public:
+            using Matrix = Eigen::Matrix<BaseType, Eigen::Dynamic, Eigen::Dynamic>;
+            using MatrixMap = Eigen::Map<Matrix>;
+            using ConstMatrixMap = Eigen::Map<const Matrix>;
+
+            /**
+             * @brief Record a linear layer on the tape
+             * @param input The BatchSize x InputSize input, in column-major order
+             * @param weights The InputSize x NumNeurons weights, in column-major order
+             * @param biases The NumNeurons biases (ignored if UseBias is false)
+             * @param weightsGradient The InputSize x NumNeurons buffer that weight gradients are accumulated into, or
+             *        nullptr if the weights are frozen and only the input gradients are needed
+             * @param biasesGradient The NumNeurons buffer that bias gradients are accumulated into (ignored if UseBias is
+             *        false or weightsGradient is nullptr)
+             */
+            LinearVari(const Derivative *input, const BaseType *weights, const BaseType *biases,
+                       BaseType *weightsGradient, BaseType *biasesGradient):
+                    vari(0.0), m_weights(weights), m_weightsGradient(weightsGradient), m_biasesGradient(biasesGradient) {
+                // Copy the varis and values of the input onto the arena
+                auto &memory = stan::math::ChainableStack::memalloc_;
+                m_inputVaris = memory.alloc_array<stan::math::vari*>(BatchSize * InputSize);
+                m_inputValues = memory.alloc_array<BaseType>(BatchSize * InputSize);
+                for (unsigned int i = 0; i < BatchSize * InputSize; i++) {
+                    m_inputVaris[i] = input[i].vi_;
+                    m_inputValues[i] = input[i].vi_->val_;
+                }
+
+                // Evaluate y = f(xW + b) using plain doubles, applying bias and activation as the output is written
+                MatrixMap output(memory.alloc_array<BaseType>(BatchSize * NumNeurons), BatchSize, NumNeurons);
+                neural::matrixProduct<BatchSize, InputSize, NumNeurons>(m_inputValues, m_weights, output.data(),
+                        Epilogue<BaseType, Activation>{UseBias ? biases : nullptr});
+
+                // Outputs are not chained individually - their adjoints are propagated by this node
+                m_outputVaris = memory.alloc_array<stan::math::vari*>(BatchSize * NumNeurons);
+                for (unsigned int i = 0; i < BatchSize * NumNeurons; i++) {
+                    m_outputVaris[i] = new stan::math::vari(output.data()[i], false);
+                }
+            }
+
+            /**
+             * @brief Get an output of the layer
+             * @param index The index of the output, in column-major order
+             * @return The output wrapped in a Derivative
+             */
+            Derivative output(unsigned int index) const {
+                return Derivative(m_outputVaris[index]);
+            }
+
+            void chain() override {
+                // Scratch space is taken from the arena as well, so the backward pass doesn't touch the heap
+                auto &memory = stan::math::ChainableStack::memalloc_;
+
+                // Gather output adjoints, and propagate them through the activation, dz = dy * f'(y)
+                MatrixMap gradOutput(memory.alloc_array<BaseType>(BatchSize * NumNeurons), BatchSize, NumNeurons);
+                for (unsigned int i = 0; i < BatchSize * NumNeurons; i++) {
+                    gradOutput.data()[i] = m_outputVaris[i]->adj_ * Activation::derivative(m_outputVaris[i]->val_);
+                }
+
+                // dx = dz * W^T
+                MatrixMap gradInput(memory.alloc_array<BaseType>(BatchSize * InputSize), BatchSize, InputSize);
+                gradInput.noalias() = gradOutput * ConstMatrixMap(m_weights, InputSize, NumNeurons).transpose();
+                for (unsigned int i = 0; i < BatchSize * InputSize; i++) {
+                    m_inputVaris[i]->adj_ += gradInput.data()[i];
+                }
+
+                // Frozen layers don't accumulate gradients for their weights and biases
+                if (m_weightsGradient == nullptr) {
+                    return;
+                }
+
+                // dW = x^T * dz, accumulated straight into the gradient buffer of the layer
+                MatrixMap(m_weightsGradient, InputSize, NumNeurons).noalias() +=
+                        ConstMatrixMap(m_inputValues, BatchSize, InputSize).transpose() * gradOutput;
+
+                // db = sum(dz) over the batch
+                if (UseBias) {
+                    for (unsigned int j = 0; j < NumNeurons; j++) {
+                        m_biasesGradient[j] += gradOutput.col(j).sum();
+                    }
+                }
+            }
+
+        private:
+            stan::math::vari** m_inputVaris = nullptr;      ///< The varis of the input
+            stan::math::vari** m_outputVaris = nullptr;     ///< The varis of the output
+            BaseType* m_inputValues = nullptr;              ///< The values of the input, used for computing dW
+            const BaseType* m_weights;                      ///< The weights of the layer, used for computing dx
+            BaseType* m_weightsGradient;                    ///< The weight gradient buffer of the layer
+            BaseType* m_biasesGradient;                     ///< The bias gradient buffer of the layer
+        };
+    }
+}
+
+#else
+
+// Inference-only mode - autodiff/gradients are not available
+// Forward declaration to keep compiler happy (this can never be instantiated due to std::enable_if usage)
+namespace neural {
+    namespace detail {
+        template <unsigned int InputSize, unsigned int NumNeurons, unsigned int BatchSize, bool UseBias, typename Activation>
+        class LinearVari;
+    }
+}
+
+#endif //AUTO_DIFF_ENABLED
+#endif //NEURAL_LINEARVARI_HPP
@@ -27,6 +27,36 @@ namespace neural {
         return Eigen::Map<const Eigen::Matrix<typename TensorIn::CoeffReturnType, Rows, Cols>>(input.data());
     }
 
+    /**
+     * @brief Maps a const tensor to a dynamically sized Eigen Matrix
+     * Products between dynamically sized maps use heap-allocated GEMM blocking, whereas large fixed-size products make
+     * Eigen reserve their blocking buffers on the stack
+     * @tparam Rows The number of rows in the input tensor
+     * @tparam Cols The number of cols in the input tensor
+     * @tparam TensorIn The type of the input tensor
+     * @param input The input tensor
+     * @return The tensor mapped to a dynamically sized Eigen Matrix
+     */
+    template <unsigned int Rows, unsigned int Cols, class TensorIn>
+    Eigen::Map<const Eigen::Matrix<typename TensorIn::CoeffReturnType, Eigen::Dynamic, Eigen::Dynamic>>
+    ConstTensorToDynamicMatrix(const TensorIn &input) {
+        return Eigen::Map<const Eigen::Matrix<typename TensorIn::CoeffReturnType, Eigen::Dynamic, Eigen::Dynamic>>(input.data(), Rows, Cols);
+    }
+
+    /**
+     * @brief Maps a tensor to a dynamically sized Eigen Matrix
+     * @tparam Rows The number of rows in the input tensor
+     * @tparam Cols The number of cols in the input tensor
+     * @tparam TensorIn The type of the input tensor
+     * @param input The input tensor
+     * @return The tensor mapped to a dynamically sized Eigen Matrix
+     */
+    template <unsigned int Rows, unsigned int Cols, class TensorIn>
+    Eigen::Map<Eigen::Matrix<typename TensorIn::CoeffReturnType, Eigen::Dynamic, Eigen::Dynamic>>
+    TensorToDynamicMatrix(TensorIn &input) {
+        return Eigen::Map<Eigen::Matrix<typename TensorIn::CoeffReturnType, Eigen::Dynamic, Eigen::Dynamic>>(input.data(), Rows, Cols);
+    }
+
     /**
      * @brief Maps a slice of a const tensor to a const Eigen Matrix (vector)
      * @tparam Size The number of elements to map (size of output vector)
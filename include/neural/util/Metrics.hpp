@@ -0,0 +1,217 @@
+/**
+* \file Metrics.hpp
+*
+* \brief Streaming accumulator of classification metrics, which evaluates batch by batch without heap allocations
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_METRICS_HPP
+#define NEURAL_METRICS_HPP
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <neural/Tensor.hpp>
+
+namespace neural {
+    namespace detail {
+        /**
+         * @brief Find the class with the largest score of a sample, without the heap allocated result of Eigen's
+         *        argmax. Ties are resolved to the lowest class index, like Eigen's argmax
+         * @tparam Scalar The scalar type of the scores
+         * @tparam BatchSize The batch size of the tensor
+         * @tparam NumClasses The number of classes
+         * @param scores The scores, e.g. probabilities or logits
+         * @param sample The index of the sample in the batch
+         * @return The index of the class with the largest score
+         */
+        template <typename Scalar, unsigned int BatchSize, unsigned int NumClasses>
+        inline unsigned int argmax(const Tensor<Scalar, BatchSize, NumClasses> &scores, unsigned int sample) {
+            unsigned int best = 0;
+            for (unsigned int c = 1; c < NumClasses; c++) {
+                if (scores(sample, c) > scores(sample, best)) {
+                    best = c;
+                }
+            }
+            return best;
+        }
+    }
+
+    /**
+     * @brief Streaming accumulator of classification metrics
+     * Batches of predictions are added one at a time, updating the counts of correct and top-k predictions, the
+     * confusion matrix and the sum of the losses in place, so evaluating a dataset allocates nothing. Accumulators
+     * filled by separate threads, e.g. on parts of a test set, are combined using merge().
+     * @tparam NumClasses The number of classes
+     * @tparam TopK The number of most probable classes that must include the label for a top-k hit
+     */
+    template <unsigned int NumClasses, unsigned int TopK = 5>
+    class Metrics {
+    public:
+        static_assert(TopK >= 1, "TopK must be at least 1");
+
+        /// The number of samples of every label (row) predicted as every class (column)
+        using ConfusionMatrix = std::array<std::array<unsigned long, NumClasses>, NumClasses>;
+
+        /**
+         * @brief Create an empty accumulator
+         */
+        Metrics() {
+            reset();
+        }
+
+        /**
+         * @brief Add a batch of predictions with labels given as class indices
+         * @tparam Scalar The scalar type of the predictions, which must be plain values, e.g. from predict()
+         * @tparam BatchSize The batch size
+         * @tparam NumLabels The number of labels, which must equal the batch size
+         * @param predictions The predicted scores of every class, e.g. probabilities or logits
+         * @param labels The class index of every sample, which must be in [0, NumClasses)
+         */
+        template <typename Scalar, unsigned int BatchSize, std::size_t NumLabels>
+        void update(const Tensor<Scalar, BatchSize, NumClasses> &predictions, const std::array<int, NumLabels> &labels) {
+            static_assert(NumLabels == BatchSize, "There must be one label per sample");
+            // Check all labels first, so an invalid batch leaves the metrics unchanged
+            for (const int label: labels) {
+                if (label < 0 || label >= static_cast<int>(NumClasses)) {
+                    throw std::runtime_error("Labels must be class indices in [0, NumClasses)");
+                }
+            }
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                addSample(predictions, i, static_cast<unsigned int>(labels[i]));
+            }
+        }
+
+        /**
+         * @brief Add a batch of predictions with one-hot labels, where the largest label of a sample is its class
+         * @tparam Scalar The scalar type of the predictions, which must be plain values, e.g. from predict()
+         * @tparam BatchSize The batch size
+         * @param predictions The predicted scores of every class, e.g. probabilities or logits
+         * @param labels The one-hot labels
+         */
+        template <typename Scalar, unsigned int BatchSize>
+        void update(const Tensor<Scalar, BatchSize, NumClasses> &predictions, const Tensor<Scalar, BatchSize, NumClasses> &labels) {
+            for (unsigned int i = 0; i < BatchSize; i++) {
+                addSample(predictions, i, detail::argmax(labels, i));
+            }
+        }
+
+        /**
+         * @brief Add the loss of a batch, which is averaged over all samples by meanLoss()
+         * @param loss The loss of the batch, averaged over its samples like the losses of this library
+         * @param numSamples The number of samples in the batch
+         */
+        void addLoss(double loss, unsigned int numSamples) {
+            m_lossSum += loss * numSamples;
+            m_lossSamples += numSamples;
+        }
+
+        /**
+         * @brief Add the metrics accumulated by another accumulator, e.g. one filled by another thread
+         * @param other The accumulator to merge
+         */
+        void merge(const Metrics &other) {
+            m_samples += other.m_samples;
+            m_correct += other.m_correct;
+            m_topK += other.m_topK;
+            m_lossSum += other.m_lossSum;
+            m_lossSamples += other.m_lossSamples;
+            for (unsigned int label = 0; label < NumClasses; label++) {
+                for (unsigned int predicted = 0; predicted < NumClasses; predicted++) {
+                    m_confusion[label][predicted] += other.m_confusion[label][predicted];
+                }
+            }
+        }
+
+        /**
+         * @brief Clear all accumulated metrics, e.g. at the start of an epoch
+         */
+        void reset() {
+            m_samples = 0;
+            m_correct = 0;
+            m_topK = 0;
+            m_lossSum = 0;
+            m_lossSamples = 0;
+            for (auto &row: m_confusion) {
+                row.fill(0);
+            }
+        }
+
+        /**
+         * @brief Get the number of samples whose predictions have been added
+         * @return The number of samples
+         */
+        unsigned long samples() const {
+            return m_samples;
+        }
+
+        /**
+         * @brief Get the fraction of samples whose most probable class is the labelled class
+         * @return The accuracy, or 0 if no samples have been added
+         */
+        double accuracy() const {
+            return m_samples == 0 ? 0.0 : double(m_correct) / m_samples;
+        }
+
+        /**
+         * @brief Get the fraction of samples whose labelled class is among the TopK most probable classes. Classes
+         *        scoring the same as the labelled class are counted in favour of the label
+         * @return The top-k accuracy, or 0 if no samples have been added
+         */
+        double topKAccuracy() const {
+            return m_samples == 0 ? 0.0 : double(m_topK) / m_samples;
+        }
+
+        /**
+         * @brief Get the loss averaged over all samples added using addLoss()
+         * @return The mean loss, or 0 if no losses have been added
+         */
+        double meanLoss() const {
+            return m_lossSamples == 0 ? 0.0 : m_lossSum / m_lossSamples;
+        }
+
+        /**
+         * @brief Get the confusion matrix
+         * @return The number of samples of every label (row) predicted as every class (column)
+         */
+        const ConfusionMatrix& confusionMatrix() const {
+            return m_confusion;
+        }
+
+    private:
+        /**
+         * @brief Add the prediction of a single sample
+         * @param predictions The predicted scores of the batch
+         * @param sample The index of the sample in the batch
+         * @param label The class index of the sample
+         */
+        template <typename Scalar, unsigned int BatchSize>
+        void addSample(const Tensor<Scalar, BatchSize, NumClasses> &predictions, unsigned int sample, unsigned int label) {
+            // The label is in the top k if fewer than k classes score strictly higher
+            const Scalar labelScore = predictions(sample, label);
+            unsigned int best = 0;
+            unsigned int higher = 0;
+            for (unsigned int c = 0; c < NumClasses; c++) {
+                const Scalar score = predictions(sample, c);
+                best = score > predictions(sample, best) ? c : best;
+                higher += score > labelScore ? 1 : 0;
+            }
+
+            m_samples++;
+            m_correct += best == label ? 1 : 0;
+            m_topK += higher < TopK ? 1 : 0;
+            m_confusion[label][best]++;
+        }
+
+        ConfusionMatrix m_confusion;    ///< The number of samples of every label predicted as every class
+        unsigned long m_samples;        ///< The number of samples added
+        unsigned long m_correct;        ///< The number of samples whose most probable class is the label
+        unsigned long m_topK;           ///< The number of samples whose label is among the TopK most probable classes
+        double m_lossSum;               ///< The sum of the losses of all samples added using addLoss()
+        unsigned long m_lossSamples;    ///< The number of samples added using addLoss()
+    };
+}
+
+#endif //NEURAL_METRICS_HPP
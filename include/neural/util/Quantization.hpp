@@ -0,0 +1,388 @@
+/**
+* \file Quantization.hpp
+*
+* \brief Symmetric int8 quantization, and int8 matrix products accumulating in int32
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_QUANTIZATION_HPP
+#define NEURAL_QUANTIZATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <Eigen/Core>
+#include <neural/util/Cpu.hpp>
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// The kernels rely on their neuron loops being fully unrolled, so the accumulators are kept in registers
+#if defined(__clang__)
+#define NEURAL_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define NEURAL_UNROLL _Pragma("GCC unroll 32")
+#else
+#define NEURAL_UNROLL
+#endif
+
+/*
+ * Layout used by the int8 matrix product C = X * W^T:
+ *  - X holds unsigned activations (quantized values offset by 128), with every group of four consecutive inputs of a
+ *    row packed into a 32-bit word, lowest input in the lowest byte. The word of group g of row i is at g * Rows + i,
+ *    so the groups of consecutive rows are contiguous, and a SIMD register holds the same group of several rows.
+ *  - W holds signed weights, one row per neuron, padded with zeros to a whole number of groups.
+ * Every kernel step multiplies a group of several rows by a group of one neuron broadcast to all lanes, and adds the
+ * four products to the int32 accumulators of the rows. C is written in column-major order, without any reductions.
+ */
+
+namespace neural {
+    namespace detail {
+        /**
+         * @brief Get a group of four consecutive weights as a 32-bit word
+         * @param w The weights of a neuron
+         * @param group The index of the group
+         * @return The four weights, lowest input in the lowest byte
+         */
+        inline std::int32_t weightGroup(const std::int8_t *w, unsigned int group) {
+            std::int32_t word;
+            std::memcpy(&word, w + 4 * group, sizeof(word));
+            return word;
+        }
+
+        /**
+         * @brief Portable implementation of the int8 kernels used by int8Gemm(), computing a single row at a time
+         */
+        struct ScalarInt8Kernel {
+            enum {
+                Rows = 1        ///< The number of rows computed by a kernel call
+            };
+
+            static const char* name() { return "scalar"; }
+
+            /**
+             * @brief Compute a tile of up to Rows rows and NR neurons of C = X * W^T
+             * @tparam NR The number of neurons in the tile
+             * @param groups The number of groups of the depth
+             * @param x The first group of the first row of the tile of X
+             * @param xStride The distance between consecutive groups of a row of X, i.e. the number of rows of X
+             * @param w The weights of the first neuron of the tile
+             * @param depth The distance between the weights of consecutive neurons
+             * @param c The first element of the tile of C
+             * @param ldc The column stride of C
+             * @param rows The number of rows left from the first row of the tile, of which at most Rows are computed
+             */
+            template <unsigned int NR>
+            static void run(unsigned int groups, const std::uint32_t *x, unsigned int xStride, const std::int8_t *w,
+                            unsigned int depth, std::int32_t *c, unsigned int ldc, unsigned int rows) {
+                for (unsigned int j = 0; j < NR; j++) {
+                    std::int32_t sum = 0;
+                    for (unsigned int g = 0; g < groups; g++) {
+                        const std::uint32_t word = x[g * xStride];
+                        for (unsigned int b = 0; b < 4; b++) {
+                            sum += std::int32_t((word >> (8 * b)) & 0xFF) * std::int32_t(w[j * depth + 4 * g + b]);
+                        }
+                    }
+                    c[j * ldc] = sum;
+                }
+            }
+        };
+
+        /**
+         * @brief The int8 kernels of an instruction set, falling back to ScalarInt8Kernel
+         * @tparam I The instruction set
+         */
+        template <Isa I>
+        struct Int8Kernel: ScalarInt8Kernel {};
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || (defined(__AVX512VNNI__) && defined(__AVX512BW__))
+        /**
+         * @brief AVX-512 VNNI implementation, which multiplies unsigned by signed bytes and adds every group of four
+         *        products to an int32 lane in a single instruction
+         */
+        template <>
+        struct Int8Kernel<Isa::AVX512VNNI> {
+            enum { Rows = 16 };
+
+            static const char* name() { return "AVX-512 VNNI"; }
+
+            template <unsigned int NR>
+            NEURAL_TARGET_AVX512VNNI
+            static void run(unsigned int groups, const std::uint32_t *x, unsigned int xStride, const std::int8_t *w,
+                            unsigned int depth, std::int32_t *c, unsigned int ldc, unsigned int rows) {
+                const __mmask16 mask = rows >= Rows ? __mmask16(0xFFFF) : __mmask16((1U << rows) - 1);
+                __m512i acc[NR];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    acc[j] = _mm512_setzero_si512();
+                }
+                for (unsigned int g = 0; g < groups; g++) {
+                    const __m512i activations = _mm512_maskz_loadu_epi32(mask, x + g * xStride);
+                    NEURAL_UNROLL
+                    for (unsigned int j = 0; j < NR; j++) {
+                        acc[j] = _mm512_dpbusd_epi32(acc[j], activations, _mm512_set1_epi32(weightGroup(w + j * depth, g)));
+                    }
+                }
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    _mm512_mask_storeu_epi32(c + j * ldc, mask, acc[j]);
+                }
+            }
+        };
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__AVX2__)
+        /**
+         * @brief AVX2 implementation, which splits every group into its even and odd bytes widened to int16, and
+         *        multiplies and adds pairs of these into int32 lanes. Unlike _mm256_maddubs_epi16, this cannot saturate
+         */
+        template <>
+        struct Int8Kernel<Isa::AVX2> {
+            enum { Rows = 8 };
+
+            static const char* name() { return "AVX2"; }
+
+            template <unsigned int NR>
+            NEURAL_TARGET_AVX2
+            static void run(unsigned int groups, const std::uint32_t *x, unsigned int xStride, const std::int8_t *w,
+                            unsigned int depth, std::int32_t *c, unsigned int ldc, unsigned int rows) {
+                const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(int(std::min(rows, 8U))),
+                                                        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                const __m256i lowBytes = _mm256_set1_epi32(0x00FF00FF);
+                __m256i acc[NR];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    acc[j] = _mm256_setzero_si256();
+                }
+                for (unsigned int g = 0; g < groups; g++) {
+                    const __m256i activations = _mm256_maskload_epi32(reinterpret_cast<const int*>(x + g * xStride), mask);
+                    const __m256i even = _mm256_and_si256(activations, lowBytes);
+                    const __m256i odd = _mm256_srli_epi16(activations, 8);
+                    NEURAL_UNROLL
+                    for (unsigned int j = 0; j < NR; j++) {
+                        // Sign extend the even and odd weights of the group to int16
+                        const __m256i weights = _mm256_set1_epi32(weightGroup(w + j * depth, g));
+                        const __m256i evenWeights = _mm256_srai_epi16(_mm256_slli_epi16(weights, 8), 8);
+                        const __m256i oddWeights = _mm256_srai_epi16(weights, 8);
+                        acc[j] = _mm256_add_epi32(acc[j], _mm256_add_epi32(_mm256_madd_epi16(even, evenWeights),
+                                                                           _mm256_madd_epi16(odd, oddWeights)));
+                    }
+                }
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    _mm256_maskstore_epi32(reinterpret_cast<int*>(c + j * ldc), mask, acc[j]);
+                }
+            }
+        };
+        /// AVX-512 without VNNI has no faster int8 instructions than AVX2
+        template <>
+        struct Int8Kernel<Isa::AVX512>: Int8Kernel<Isa::AVX2> {};
+#endif
+
+#if defined(NEURAL_RUNTIME_DISPATCH) || defined(__SSE2__)
+        /**
+         * @brief SSE2 implementation of the AVX2 kernel. SSE2 has no masked loads and stores, so partial tiles of rows
+         *        go through a zero-padded copy
+         */
+        template <>
+        struct Int8Kernel<Isa::SSE2> {
+            enum { Rows = 4 };
+
+            static const char* name() { return "SSE2"; }
+
+            template <unsigned int NR>
+            static void run(unsigned int groups, const std::uint32_t *x, unsigned int xStride, const std::int8_t *w,
+                            unsigned int depth, std::int32_t *c, unsigned int ldc, unsigned int rows) {
+                const bool full = rows >= Rows;
+                const __m128i lowBytes = _mm_set1_epi32(0x00FF00FF);
+                __m128i acc[NR];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    acc[j] = _mm_setzero_si128();
+                }
+                for (unsigned int g = 0; g < groups; g++) {
+                    const __m128i activations = full ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + g * xStride))
+                                                     : loadPartial(x + g * xStride, rows);
+                    const __m128i even = _mm_and_si128(activations, lowBytes);
+                    const __m128i odd = _mm_srli_epi16(activations, 8);
+                    NEURAL_UNROLL
+                    for (unsigned int j = 0; j < NR; j++) {
+                        const __m128i weights = _mm_set1_epi32(weightGroup(w + j * depth, g));
+                        const __m128i evenWeights = _mm_srai_epi16(_mm_slli_epi16(weights, 8), 8);
+                        const __m128i oddWeights = _mm_srai_epi16(weights, 8);
+                        acc[j] = _mm_add_epi32(acc[j], _mm_add_epi32(_mm_madd_epi16(even, evenWeights),
+                                                                     _mm_madd_epi16(odd, oddWeights)));
+                    }
+                }
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < NR; j++) {
+                    if (full) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(c + j * ldc), acc[j]);
+                    } else {
+                        std::int32_t result[Rows];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(result), acc[j]);
+                        std::copy(result, result + rows, c + j * ldc);
+                    }
+                }
+            }
+
+        private:
+            static __m128i loadPartial(const std::uint32_t *x, unsigned int rows) {
+                std::uint32_t padded[Rows] = {};
+                std::copy(x, x + rows, padded);
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded));
+            }
+        };
+#endif
+    }
+
+    /**
+     * @brief Pad a depth to a whole number of the groups of four used by int8Gemm()
+     * @param depth The depth to pad
+     * @return The padded depth
+     */
+    constexpr unsigned int int8PaddedDepth(unsigned int depth) {
+        return (depth + 3) / 4 * 4;
+    }
+
+    /**
+     * @brief Quantize a vector symmetrically to int8, q = round(x / scale), where scale maps the largest magnitude in
+     *        the vector to 127
+     * @tparam Scalar The scalar type
+     * @param x The vector to quantize
+     * @param size The number of elements in x
+     * @param q [out]: The size quantized elements
+     * @return The scale of the quantized elements, which is 0 if all elements are 0
+     */
+    template <typename Scalar>
+    Scalar quantizeSymmetric(const Scalar *x, unsigned int size, std::int8_t *q) {
+        Scalar maxMagnitude = 0;
+        for (unsigned int k = 0; k < size; k++) {
+            maxMagnitude = std::max(maxMagnitude, std::abs(x[k]));
+        }
+        const Scalar scale = maxMagnitude / Scalar(127);
+        const Scalar inverseScale = scale > Scalar(0) ? Scalar(1) / scale : Scalar(0);
+        for (unsigned int k = 0; k < size; k++) {
+            const long rounded = std::lround(x[k] * inverseScale);
+            q[k] = static_cast<std::int8_t>(std::min(127L, std::max(-127L, rounded)));
+        }
+        return scale;
+    }
+
+    /**
+     * @brief Quantize every row of a matrix of activations like quantizeSymmetric(), each with its own scale, but offset
+     *        by 128 to the unsigned bytes consumed by int8Gemm(). Products with these must be corrected by subtracting
+     *        128 times the sum of the weights
+     * Four columns are read at a time, so all loads are contiguous and the loops vectorize. This matters as much as the
+     * product itself for layers with few neurons
+     * @tparam Rows The number of rows of the matrix
+     * @tparam Size The number of columns of the matrix
+     * @tparam Scalar The scalar type
+     * @param x The Rows x Size matrix, in column-major order
+     * @param scales [out]: The Rows scales of the quantized rows, which are 0 for rows of only zeros
+     * @param q [out]: The Rows x int8PaddedDepth(Size) quantized matrix, in the grouped layout of int8Gemm()
+     */
+    template <unsigned int Rows, unsigned int Size, typename Scalar>
+    void quantizeActivations(const Scalar *x, Scalar *scales, std::uint32_t *q) {
+        using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+        using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+        Eigen::Map<Vector>(scales, Rows) = Eigen::Map<const Matrix>(x, Rows, Size).cwiseAbs().rowwise().maxCoeff() / Scalar(127);
+        Scalar inverseScales[Rows];
+        for (unsigned int i = 0; i < Rows; i++) {
+            inverseScales[i] = scales[i] > Scalar(0) ? Scalar(1) / scales[i] : Scalar(0);
+        }
+
+        // The offset values are positive, so rounding to nearest is adding 0.5 and truncating
+        const auto quantize = [&inverseScales](Scalar value, unsigned int i) {
+            return std::uint32_t(std::int32_t(value * inverseScales[i] + Scalar(128.5)));
+        };
+        constexpr unsigned int FullGroups = Size / 4;
+        for (unsigned int g = 0; g < FullGroups; g++) {
+            const Scalar *columns = x + 4 * g * Rows;
+            for (unsigned int i = 0; i < Rows; i++) {
+                q[g * Rows + i] = quantize(columns[i], i) | (quantize(columns[i + Rows], i) << 8) |
+                                  (quantize(columns[i + 2 * Rows], i) << 16) | (quantize(columns[i + 3 * Rows], i) << 24);
+            }
+        }
+
+        // Pad the last group with the quantized value of 0
+        if (Size % 4 != 0) {
+            for (unsigned int i = 0; i < Rows; i++) {
+                std::uint32_t word = 0;
+                for (unsigned int b = 0; b < 4; b++) {
+                    const unsigned int k = 4 * FullGroups + b;
+                    word |= (k < Size ? quantize(x[i + k * Rows], i) : std::uint32_t(128)) << (8 * b);
+                }
+                q[FullGroups * Rows + i] = word;
+            }
+        }
+    }
+
+    namespace detail {
+        /**
+         * @brief Compute C = X * W^T with the int8 kernels of an instruction set (see int8Gemm())
+         */
+        template <unsigned int Rows, unsigned int Depth, unsigned int Columns, Isa I>
+        void int8Gemm(const std::uint32_t *x, const std::int8_t *w, std::int32_t *c) {
+            static_assert(Depth % 4 == 0, "The depth of int8Gemm must be padded using int8PaddedDepth");
+            using Kernel = Int8Kernel<I>;
+            constexpr unsigned int Groups = Depth / 4;
+
+            unsigned int j = 0;
+            for (; j + 8 <= Columns; j += 8) {
+                for (unsigned int i = 0; i < Rows; i += Kernel::Rows) {
+                    Kernel::template run<8>(Groups, x + i, Rows, w + j * Depth, Depth, c + i + j * Rows, Rows, Rows - i);
+                }
+            }
+            for (; j + 4 <= Columns; j += 4) {
+                for (unsigned int i = 0; i < Rows; i += Kernel::Rows) {
+                    Kernel::template run<4>(Groups, x + i, Rows, w + j * Depth, Depth, c + i + j * Rows, Rows, Rows - i);
+                }
+            }
+            for (; j < Columns; j++) {
+                for (unsigned int i = 0; i < Rows; i += Kernel::Rows) {
+                    Kernel::template run<1>(Groups, x + i, Rows, w + j * Depth, Depth, c + i + j * Rows, Rows, Rows - i);
+                }
+            }
+        }
+
+        /**
+         * @brief Function object computing C = X * W^T with the int8 kernels of the instruction set it is called with
+         */
+        template <unsigned int Rows, unsigned int Depth, unsigned int Columns>
+        struct Int8Gemm {
+            const std::uint32_t *x;
+            const std::int8_t *w;
+            std::int32_t *c;
+
+            template <Isa I>
+            void operator()(IsaTag<I>) const {
+                int8Gemm<Rows, Depth, Columns, I>(x, w, c);
+            }
+        };
+    }
+
+    /**
+     * @brief Compute the int8 matrix product C = X * W^T, accumulating in int32, using the widest instruction set
+     *        supported by the CPU (AVX-512 VNNI, AVX2, SSE2 or scalar, see cpuIsa())
+     * Every tile of neurons sweeps all rows of X, so W is streamed from memory once per product while X stays in cache
+     * @tparam Rows The number of rows of X and C
+     * @tparam Depth The padded depth of the product (see int8PaddedDepth())
+     * @tparam Columns The number of rows of W and columns of C
+     * @param x The Rows x Depth matrix X of unsigned activations, in the grouped layout (see quantizeActivations())
+     * @param w The Columns x Depth matrix W of signed weights, in row-major order
+     * @param c [out]: The Rows x Columns matrix C, in column-major order
+     */
+    template <unsigned int Rows, unsigned int Depth, unsigned int Columns>
+    void int8Gemm(const std::uint32_t *x, const std::int8_t *w, std::int32_t *c) {
+        detail::dispatch<Isa::AVX512VNNI>(detail::Int8Gemm<Rows, Depth, Columns>{x, w, c});
+    }
+}
+
+#undef NEURAL_UNROLL
+
+#endif //NEURAL_QUANTIZATION_HPP
@@ -0,0 +1,304 @@
+/**
+* \file SparseGemm.hpp
+*
+* \brief Block-sparse matrices, magnitude pruning of dense matrices into them, and block-sparse matrix products
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_SPARSEGEMM_HPP
+#define NEURAL_SPARSEGEMM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <neural/util/Gemm.hpp>
+
+// The kernels rely on their block loops being fully unrolled, so the accumulators are kept in registers
+#if defined(__clang__)
+#define NEURAL_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define NEURAL_UNROLL _Pragma("GCC unroll 32")
+#else
+#define NEURAL_UNROLL
+#endif
+
+namespace neural {
+    /**
+     * @brief Sparse matrix made of dense BlockRows x BlockColumns blocks, in a block compressed sparse column format
+     * The columns are split into block columns of BlockColumns columns, the last of which is padded with zeros. The
+     * blocks of block column g are blocks columnStarts[g] to columnStarts[g + 1] - 1, ordered by their first row
+     * @tparam Scalar The scalar type
+     * @tparam BlockRows The number of rows of a block
+     * @tparam BlockColumns The number of columns of a block
+     */
+    template <typename Scalar, unsigned int BlockRows, unsigned int BlockColumns>
+    struct BlockSparseMatrix {
+        std::vector<unsigned int> columnStarts;     ///< The index of the first block of every block column, and the number of blocks
+        std::vector<unsigned int> blockRows;        ///< The first row of every block
+        std::vector<Scalar> values;                 ///< The values of every block, in row-major order
+
+        /**
+         * @brief Get the number of stored blocks
+         * @return The number of blocks
+         */
+        unsigned int blocks() const {
+            return static_cast<unsigned int>(blockRows.size());
+        }
+    };
+
+    namespace detail {
+        /**
+         * @brief Kernel computing a RowPackets*Lanes x BlockColumns tile of C = A * B for a block column of a
+         *        block-sparse B, keeping the whole tile in registers
+         * Every block loads BlockRows column segments of A, picked by the row of the block, and broadcasts the values
+         * of the block to accumulate their outer products, like the dense microkernels of gemm(). The bias and
+         * activation are applied to the tile while it is still in registers
+         * @tparam P The packet operations
+         * @tparam RowPackets The number of packets of rows in the tile
+         * @tparam BlockRows The number of rows of a block
+         * @tparam BlockColumns The number of columns of a block
+         */
+        template <typename P, unsigned int RowPackets, unsigned int BlockRows, unsigned int BlockColumns>
+        struct BlockSparseKernel {
+            /**
+             * @brief Compute a tile of C
+             * @tparam Scalar The scalar type
+             * @param a The top left element of the tile rows of A
+             * @param lda The column stride of A
+             * @param rows The first row of every block in the block column
+             * @param values The values of the blocks in the block column
+             * @param blocks The number of blocks in the block column
+             * @param c The top left element of the tile of C
+             * @param ldc The column stride of C
+             * @param columns The number of columns of the tile to store, which may be less than BlockColumns
+             * @param epilogue The epilogue of the tile columns of C
+             */
+            template <typename Scalar, typename Activation>
+            static inline void run(const Scalar *a, unsigned int lda, const unsigned int *rows, const Scalar *values,
+                                   unsigned int blocks, Scalar *c, unsigned int ldc, unsigned int columns,
+                                   const Epilogue<Scalar, Activation> &epilogue) {
+                typename P::Packet acc[RowPackets][BlockColumns];
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < BlockColumns; j++) {
+                    NEURAL_UNROLL
+                    for (unsigned int r = 0; r < RowPackets; r++) {
+                        if (epilogue.bias != nullptr && j < columns) {
+                            P::broadcast(epilogue.bias[j], acc[r][j]);
+                        } else {
+                            P::zero(acc[r][j]);
+                        }
+                    }
+                }
+
+                for (unsigned int b = 0; b < blocks; b++) {
+                    const Scalar *block = values + b * BlockRows * BlockColumns;
+                    NEURAL_UNROLL
+                    for (unsigned int k = 0; k < BlockRows; k++) {
+                        const Scalar *column = a + (rows[b] + k) * lda;
+                        typename P::Packet x[RowPackets];
+                        NEURAL_UNROLL
+                        for (unsigned int r = 0; r < RowPackets; r++) {
+                            P::load(column + r * P::Lanes, x[r]);
+                        }
+                        NEURAL_UNROLL
+                        for (unsigned int j = 0; j < BlockColumns; j++) {
+                            typename P::Packet element;
+                            P::broadcast(block[k * BlockColumns + j], element);
+                            NEURAL_UNROLL
+                            for (unsigned int r = 0; r < RowPackets; r++) {
+                                P::fmadd(x[r], element, acc[r][j], acc[r][j]);
+                            }
+                        }
+                    }
+                }
+
+                NEURAL_UNROLL
+                for (unsigned int j = 0; j < BlockColumns; j++) {
+                    if (j < columns) {
+                        NEURAL_UNROLL
+                        for (unsigned int r = 0; r < RowPackets; r++) {
+                            Activation::template applyPacket<P, Scalar>(acc[r][j]);
+                            P::store(c + j * ldc + r * P::Lanes, acc[r][j]);
+                        }
+                    }
+                }
+            }
+        };
+    }
+
+    /**
+     * @brief Prune a dense K x N matrix to a block-sparse matrix, keeping the blocks with the largest L2 norms
+     * @tparam K The number of rows of the matrix, which must be a multiple of BlockRows
+     * @tparam N The number of columns of the matrix
+     * @tparam Scalar The scalar type
+     * @tparam BlockRows The number of rows of a block
+     * @tparam BlockColumns The number of columns of a block
+     * @param dense The K x N matrix, in column-major order
+     * @param sparsity The fraction of blocks to prune, in [0, 1]
+     * @param sparse [out]: The pruned matrix
+     */
+    template <unsigned int K, unsigned int N, typename Scalar, unsigned int BlockRows, unsigned int BlockColumns>
+    void pruneBlocks(const Scalar *dense, double sparsity, BlockSparseMatrix<Scalar, BlockRows, BlockColumns> &sparse) {
+        static_assert(K % BlockRows == 0, "The number of rows must be a multiple of the number of rows of a block");
+        if (!(sparsity >= 0.0 && sparsity <= 1.0)) {
+            throw std::runtime_error("The sparsity must be in [0, 1]");
+        }
+        constexpr unsigned int RowBlocks = K / BlockRows;
+        constexpr unsigned int ColumnBlocks = (N + BlockColumns - 1) / BlockColumns;
+
+        // The squared norm of every block, indexed by block column, then block row
+        std::vector<Scalar> norms(RowBlocks * ColumnBlocks, Scalar(0));
+        for (unsigned int j = 0; j < N; j++) {
+            for (unsigned int k = 0; k < K; k++) {
+                const Scalar value = dense[k + j * K];
+                norms[(j / BlockColumns) * RowBlocks + k / BlockRows] += value * value;
+            }
+        }
+
+        // Keep the largest blocks, breaking ties by position so the pruning is deterministic
+        const unsigned int kept = static_cast<unsigned int>(std::lround((1.0 - sparsity) * norms.size()));
+        std::vector<unsigned int> order(norms.size());
+        for (unsigned int i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::nth_element(order.begin(), order.begin() + kept, order.end(), [&norms](unsigned int x, unsigned int y) {
+            return norms[x] > norms[y] || (norms[x] == norms[y] && x < y);
+        });
+        std::vector<bool> keep(norms.size(), false);
+        for (unsigned int i = 0; i < kept; i++) {
+            keep[order[i]] = true;
+        }
+
+        sparse.columnStarts.assign(1, 0);
+        sparse.blockRows.clear();
+        sparse.values.clear();
+        for (unsigned int g = 0; g < ColumnBlocks; g++) {
+            for (unsigned int p = 0; p < RowBlocks; p++) {
+                if (!keep[g * RowBlocks + p]) {
+                    continue;
+                }
+                sparse.blockRows.push_back(p * BlockRows);
+                for (unsigned int k = p * BlockRows; k < (p + 1) * BlockRows; k++) {
+                    for (unsigned int j = g * BlockColumns; j < (g + 1) * BlockColumns; j++) {
+                        sparse.values.push_back(j < N ? dense[k + j * K] : Scalar(0));
+                    }
+                }
+            }
+            sparse.columnStarts.push_back(sparse.blocks());
+        }
+    }
+
+    /**
+     * @brief Expand a block-sparse matrix to a dense matrix, with zeros for the pruned blocks
+     * @tparam K The number of rows of the matrix
+     * @tparam N The number of columns of the matrix
+     * @tparam Scalar The scalar type
+     * @tparam BlockRows The number of rows of a block
+     * @tparam BlockColumns The number of columns of a block
+     * @param sparse The block-sparse matrix
+     * @param dense [out]: The K x N matrix, in column-major order
+     */
+    template <unsigned int K, unsigned int N, typename Scalar, unsigned int BlockRows, unsigned int BlockColumns>
+    void densify(const BlockSparseMatrix<Scalar, BlockRows, BlockColumns> &sparse, Scalar *dense) {
+        std::fill(dense, dense + K * N, Scalar(0));
+        for (unsigned int g = 0; g + 1 < sparse.columnStarts.size(); g++) {
+            for (unsigned int b = sparse.columnStarts[g]; b < sparse.columnStarts[g + 1]; b++) {
+                for (unsigned int k = 0; k < BlockRows; k++) {
+                    for (unsigned int j = 0; j < BlockColumns && g * BlockColumns + j < N; j++) {
+                        dense[sparse.blockRows[b] + k + (g * BlockColumns + j) * K] = sparse.values[(b * BlockRows + k) * BlockColumns + j];
+                    }
+                }
+            }
+        }
+    }
+
+    namespace detail {
+        /**
+         * @brief Compute C = A * B for a block-sparse B with the kernels of an instruction set (see blockSparseGemm())
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, Isa I, typename Scalar, unsigned int BlockRows, unsigned int BlockColumns,
+                  typename Activation>
+        void blockSparseGemm(const Scalar *a, const BlockSparseMatrix<Scalar, BlockRows, BlockColumns> &b, Scalar *c,
+                             const Epilogue<Scalar, Activation> &epilogue) {
+            using Packet = SimdPacket<Scalar, I>;
+            constexpr unsigned int Lanes = Packet::Lanes;
+            using HalfPacket = HalfSimdPacket<Scalar, I>;
+            constexpr unsigned int HalfLanes = HalfPacket::Lanes;
+            // Use two packets of rows per tile when there are enough rows and registers, to hide the latency of the FMAs
+            constexpr unsigned int RowPackets = M >= 2 * Lanes && 2 * BlockColumns + 3 <= Packet::Registers ? 2 : 1;
+            constexpr unsigned int MR = RowPackets * Lanes;
+
+            for (unsigned int g = 0; g * BlockColumns < N; g++) {
+                const unsigned int first = b.columnStarts[g];
+                const unsigned int blocks = b.columnStarts[g + 1] - first;
+                const unsigned int *rows = b.blockRows.data() + first;
+                const Scalar *values = b.values.data() + first * BlockRows * BlockColumns;
+                const unsigned int columns = std::min(BlockColumns, N - g * BlockColumns);
+                Scalar *cBlock = c + g * BlockColumns * M;
+                const Epilogue<Scalar, Activation> blockEpilogue = epilogue.columns(g * BlockColumns);
+
+                unsigned int i = 0;
+                for (; i + MR <= M; i += MR) {
+                    BlockSparseKernel<Packet, RowPackets, BlockRows, BlockColumns>::run(a + i, M, rows, values, blocks, cBlock + i, M, columns, blockEpilogue);
+                }
+                for (; i + Lanes <= M; i += Lanes) {
+                    BlockSparseKernel<Packet, 1, BlockRows, BlockColumns>::run(a + i, M, rows, values, blocks, cBlock + i, M, columns, blockEpilogue);
+                }
+                for (; i + HalfLanes <= M; i += HalfLanes) {
+                    BlockSparseKernel<HalfPacket, 1, BlockRows, BlockColumns>::run(a + i, M, rows, values, blocks, cBlock + i, M, columns, blockEpilogue);
+                }
+                for (; i < M; i++) {
+                    BlockSparseKernel<ScalarPacket<Scalar>, 1, BlockRows, BlockColumns>::run(a + i, M, rows, values, blocks, cBlock + i, M, columns, blockEpilogue);
+                }
+            }
+        }
+
+        /**
+         * @brief Function object computing C = A * B for a block-sparse B with the kernels of the instruction set it is
+         *        called with
+         */
+        template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, unsigned int BlockRows, unsigned int BlockColumns,
+                  typename Activation>
+        struct BlockSparseGemm {
+            const Scalar *a;
+            const BlockSparseMatrix<Scalar, BlockRows, BlockColumns> &b;
+            Scalar *c;
+            const Epilogue<Scalar, Activation> &epilogue;
+
+            template <Isa I>
+            void operator()(IsaTag<I>) const {
+                blockSparseGemm<M, K, N, I>(a, b, c, epilogue);
+            }
+        };
+    }
+
+    /**
+     * @brief Compute the matrix product C = A * B, where A is a dense M x K matrix, B is a block-sparse K x N matrix
+     *        and C is M x N, using the widest instruction set supported by the CPU (see cpuIsa())
+     * Only the stored blocks of B are multiplied, so the work scales with the density of B. Every block column of B
+     * sweeps all rows of A, so the blocks are streamed from memory once per product while A stays in cache
+     * @tparam M The number of rows of A and C
+     * @tparam K The number of columns of A and rows of B
+     * @tparam N The number of columns of B and C
+     * @tparam Scalar The scalar type
+     * @tparam BlockRows The number of rows of a block of B
+     * @tparam BlockColumns The number of columns of a block of B
+     * @param a The M x K matrix A, in column-major order
+     * @param b The block-sparse matrix B, pruned by pruneBlocks<K, N>()
+     * @param c [out]: The M x N matrix C, in column-major order, which must not alias A
+     * @param epilogue The bias and activation to apply to C, none by default
+     */
+    template <unsigned int M, unsigned int K, unsigned int N, typename Scalar, unsigned int BlockRows, unsigned int BlockColumns,
+              typename Activation = activation::Identity>
+    void blockSparseGemm(const Scalar *a, const BlockSparseMatrix<Scalar, BlockRows, BlockColumns> &b, Scalar *c,
+                         const Epilogue<Scalar, Activation> &epilogue = Epilogue<Scalar, Activation>()) {
+        detail::dispatch<Isa::AVX512>(detail::BlockSparseGemm<M, K, N, Scalar, BlockRows, BlockColumns, Activation>{a, b, c, epilogue});
+    }
+}
+
+#undef NEURAL_UNROLL
+
+#endif //NEURAL_SPARSEGEMM_HPP
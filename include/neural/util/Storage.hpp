@@ -0,0 +1,202 @@
+/**
+* \file Storage.hpp
+*
+* \brief Reduced precision scalar types, and policies selecting the type that layer weights are stored in
+*
+* \date   Oct 17, 2026
+* \author Mathias Bøgh Stokholm
+*/
+
+#ifndef NEURAL_STORAGE_HPP
+#define NEURAL_STORAGE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace neural {
+    namespace detail {
+        inline std::uint32_t floatBits(float value) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline float bitsFloat(std::uint32_t bits) {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+
+    /**
+     * @brief Brain floating point, the upper 16 bits of an IEEE 754 float. It has the range of a float, but only 8 bits
+     *        of precision. Conversion from float rounds to nearest even, and conversion to float is exact
+     */
+    struct bfloat16 {
+        std::uint16_t bits;     ///< The upper 16 bits of the float
+
+        bfloat16() = default;
+
+        explicit bfloat16(float value) {
+            const std::uint32_t floatBits = detail::floatBits(value);
+            if (std::isnan(value)) {
+                // Keep NaNs quiet, instead of rounding their payload into infinity
+                bits = std::uint16_t((floatBits >> 16) | 0x40);
+            } else {
+                const std::uint32_t rounding = 0x7FFF + ((floatBits >> 16) & 1);
+                bits = std::uint16_t((floatBits + rounding) >> 16);
+            }
+        }
+
+        explicit operator float() const {
+            return detail::bitsFloat(std::uint32_t(bits) << 16);
+        }
+
+        explicit operator double() const {
+            return static_cast<float>(*this);
+        }
+    };
+
+    /**
+     * @brief IEEE 754 half precision float, with 11 bits of precision and a range of +-65504. Conversion from float
+     *        rounds to nearest even, and conversion to float is exact. F16C instructions are used if enabled
+     */
+    struct float16 {
+        std::uint16_t bits;     ///< The bits of the half precision float
+
+        float16() = default;
+
+        explicit float16(float value) {
+#if defined(__F16C__)
+            bits = std::uint16_t(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+            const std::uint32_t floatBits = detail::floatBits(value);
+            const std::uint32_t sign = (floatBits >> 16) & 0x8000;
+            std::uint32_t magnitude = floatBits & 0x7FFFFFFF;
+            if (magnitude >= 0x7F800000) {
+                // Infinity or NaN
+                bits = std::uint16_t(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0));
+            } else if (magnitude >= 0x477FF000) {
+                // Rounds to a value above 65504
+                bits = std::uint16_t(sign | 0x7C00);
+            } else if (magnitude < 0x38800000) {
+                // Subnormal, in steps of 2^-24
+                bits = std::uint16_t(sign | std::uint32_t(std::nearbyint(detail::bitsFloat(magnitude) * 16777216.0f)));
+            } else {
+                // Normal: rebias the exponent from 127 to 15, and round the mantissa to nearest even
+                magnitude += 0xC8000FFF + ((magnitude >> 13) & 1);
+                bits = std::uint16_t(sign | (magnitude >> 13));
+            }
+#endif
+        }
+
+        explicit operator float() const {
+#if defined(__F16C__)
+            return _cvtsh_ss(bits);
+#else
+            const std::uint32_t sign = std::uint32_t(bits & 0x8000) << 16;
+            const std::uint32_t exponent = (bits >> 10) & 0x1F;
+            const std::uint32_t mantissa = bits & 0x3FF;
+            if (exponent == 0) {
+                const float magnitude = std::ldexp(float(mantissa), -24);
+                return sign ? -magnitude : magnitude;
+            }
+            if (exponent == 0x1F) {
+                return detail::bitsFloat(sign | 0x7F800000 | (mantissa << 13));
+            }
+            return detail::bitsFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+#endif
+        }
+
+        explicit operator double() const {
+            return static_cast<float>(*this);
+        }
+    };
+
+    /**
+     * @brief Convert an array of scalars, e.g. to widen reduced precision weights before they are used
+     * @param source The scalars to convert
+     * @param size The number of scalars
+     * @param destination [out]: The converted scalars
+     */
+    template <typename Source, typename Destination>
+    inline void convert(const Source *source, std::size_t size, Destination *destination) {
+        for (std::size_t i = 0; i < size; i++) {
+            destination[i] = static_cast<Destination>(source[i]);
+        }
+    }
+
+    /**
+     * @brief Widen bfloat16 to float, 8 at a time by interleaving them with zeros as the lower halves of the floats
+     */
+    inline void convert(const bfloat16 *source, std::size_t size, float *destination) {
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (const std::size_t vectorized = size - size % 8; i < vectorized; i += 8) {
+            const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_unpacklo_epi16(zero, halves));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i + 4), _mm_unpackhi_epi16(zero, halves));
+        }
+#endif
+        for (; i < size; i++) {
+            destination[i] = static_cast<float>(source[i]);
+        }
+    }
+
+#if defined(__F16C__)
+    /**
+     * @brief Widen float16 to float, 8 at a time using F16C
+     */
+    inline void convert(const float16 *source, std::size_t size, float *destination) {
+        std::size_t i = 0;
+        for (const std::size_t vectorized = size - size % 8; i < vectorized; i += 8) {
+            const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(halves));
+        }
+        for (; i < size; i++) {
+            destination[i] = static_cast<float>(source[i]);
+        }
+    }
+#endif
+
+    /**
+     * @brief Policies selecting the scalar type that the weights of a layer are stored in. Weights are widened back to
+     *        the scalar type of the layer a cache-sized block at a time into a buffer on the stack, right before they are
+     *        used, so reduced precision storage halves the memory of float weights without changing the precision of
+     *        the arithmetic
+     */
+    namespace storage {
+        /**
+         * @brief Store weights at the full precision of the layer
+         */
+        struct Full {
+            template<typename Scalar>
+            using Type = Scalar;
+        };
+
+        /**
+         * @brief Store weights as bfloat16, which keeps the range of a float at 8 bits of precision
+         */
+        struct BFloat16 {
+            template<typename Scalar>
+            using Type = bfloat16;
+        };
+
+        /**
+         * @brief Store weights as IEEE half precision floats, which have 11 bits of precision but a range of +-65504
+         */
+        struct Float16 {
+            template<typename Scalar>
+            using Type = float16;
+        };
+    }
+}
+
+#endif //NEURAL_STORAGE_HPP
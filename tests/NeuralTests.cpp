@@ -28,6 +28,81 @@ TEST_CASE("Testing tensor -> matrix/vector mapping functions", "[mapping]" ) {
     }
 }
 
+/**
+ * @brief Check the microkernels of neural::gemm, with and without a pre-packed B, against Eigen's matrix product for a
+ *        given set of sizes
+ */
+template <typename Scalar, unsigned int M, unsigned int K, unsigned int N>
+void checkGemm() {
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    const Matrix a = Matrix::Random(M, K);
+    const Matrix b = Matrix::Random(K, N);
+    const Matrix expected = a * b;
+    Matrix c(M, N);
+    neural::gemm<M, K, N>(a.data(), b.data(), c.data());
+    REQUIRE( (c - expected).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+
+    Matrix packed(K, N);
+    neural::packGemmRhs<M, K, N>(b.data(), packed.data());
+    neural::gemmPacked<M, K, N>(a.data(), packed.data(), c.data());
+    REQUIRE( (c - expected).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+
+    // Bias and activation applied to the tiles before they are stored
+    using RowVector = Eigen::Matrix<Scalar, 1, Eigen::Dynamic>;
+    const RowVector bias = RowVector::Random(N);
+    const Matrix expectedRelu = (expected.rowwise() + bias).cwiseMax(Scalar(0));
+    neural::gemm<M, K, N>(a.data(), b.data(), c.data(), neural::Epilogue<Scalar, neural::activation::Relu>{bias.data()});
+    REQUIRE( (c - expectedRelu).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+    const Matrix expectedSigmoid = ((-(expected.rowwise() + bias)).array().exp() + Scalar(1)).inverse().matrix();
+    neural::gemmPacked<M, K, N>(a.data(), packed.data(), c.data(), neural::Epilogue<Scalar, neural::activation::Sigmoid>{bias.data()});
+    REQUIRE( (c - expectedSigmoid).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+}
+
+TEST_CASE("Testing gemm", "[gemm]" ) {
+    // Sizes covering full and partial tiles, packing of B and blocking of the depth
+    checkGemm<double, 1, 7, 3>();
+    checkGemm<double, 13, 37, 11>();
+    checkGemm<double, 64, 300, 10>();
+    checkGemm<double, 33, 784, 29>();
+    checkGemm<float, 5, 9, 2>();
+    checkGemm<float, 70, 513, 17>();
+}
+
+/**
+ * @brief Check neural::gemv, with B at full and at reduced precision, against Eigen's matrix product
+ */
+template <typename Scalar, unsigned int K, unsigned int N>
+void checkGemv() {
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    const Matrix x = Matrix::Random(1, K);
+    const Matrix b = Matrix::Random(K, N);
+    Matrix y(1, N);
+    neural::gemv<K, N>(x.data(), b.data(), y.data());
+    REQUIRE( (y - x * b).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+
+    std::vector<neural::bfloat16> reduced(K * N);
+    neural::convert(b.data(), K * N, reduced.data());
+    Matrix widened(K, N);
+    neural::convert(reduced.data(), K * N, widened.data());
+    neural::gemv<K, N>(x.data(), reduced.data(), y.data());
+    REQUIRE( (y - x * widened).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+
+    // Bias and activation applied to the dot products before they are stored
+    const Matrix bias = Matrix::Random(1, N);
+    neural::gemv<K, N>(x.data(), b.data(), y.data(), neural::Epilogue<Scalar, neural::activation::Tanh>{bias.data()});
+    REQUIRE( (y.array() - (x * b + bias).array().tanh()).abs().maxCoeff() < Scalar(1e-3) );
+}
+
+TEST_CASE("Testing gemv", "[gemv]" ) {
+    // Sizes covering all column kernels, partial packets and widening in several blocks
+    checkGemv<double, 1, 1>();
+    checkGemv<double, 13, 11>();
+    checkGemv<double, 784, 29>();
+    checkGemv<float, 9, 2>();
+    checkGemv<float, 64, 128>();
+    checkGemv<float, 1025, 7>();
+}
+
 TEST_CASE("Testing activation functions", "[activations]" ) {
     constexpr int numInputs = 7;
     neural::Tensor<double, 1, numInputs> x, expectedValues;
@@ -83,6 +158,101 @@ TEST_CASE("Testing loss functions", "[losses]" ) {
     REQUIRE( accuracy == 0 );
 }
 
+TEST_CASE("Testing softmax cross entropy", "[softmax_cross_entropy]" ) {
+    constexpr int numClasses = 4;
+    constexpr int batchSize = 3;
+    neural::Tensor<double, batchSize, numClasses> logits, labels;
+    logits.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}, {0.5, 1, 1.5, -1}});
+    labels.setValues({{0, 0, 1, 0}, {0, 0, 1, 0}, {0.2, 0.3, 0.5, 0}});
+
+    // The fused loss and its gradient must equal cross entropy on the probabilities of a Softmax layer
+    neural::Softmax<double, numClasses, batchSize> softmax;
+    neural::CrossEntropy<double, numClasses, batchSize> crossEntropy;
+    neural::SoftmaxCrossEntropy<double, numClasses, batchSize> softmaxCrossEntropy;
+    const auto probabilities = softmax.forward(logits);
+    REQUIRE( softmaxCrossEntropy.compute(logits, labels) == Approx(crossEntropy.compute(probabilities, labels)) );
+    const auto expected = softmax.backward(logits, probabilities, crossEntropy.gradient(probabilities, labels));
+    const auto gradient = softmaxCrossEntropy.gradient(logits, labels);
+    for (int i = 0; i < batchSize * numClasses; i++) {
+        REQUIRE( gradient.data()[i] == Approx(expected.data()[i]).margin(1e-6) );
+    }
+    REQUIRE( softmaxCrossEntropy.accuracy(logits, labels) == Approx(2.0 / 3) );
+
+    // Shifting the logits doesn't change the loss, even where the exponentials overflow. Confidently wrong logits have
+    // a large but finite loss, where the probabilities underflow to zero
+    neural::Tensor<double, batchSize, numClasses> shifted = logits, scaled = logits;
+    for (int i = 0; i < batchSize * numClasses; i++) {
+        shifted.data()[i] += 1000;
+        scaled.data()[i] *= 1000;
+    }
+    REQUIRE( softmaxCrossEntropy.compute(shifted, labels) == Approx(softmaxCrossEntropy.compute(logits, labels)) );
+    REQUIRE( softmaxCrossEntropy.compute(scaled, labels) == Approx((1200.0 + 350.0) / batchSize) );
+}
+
+TEST_CASE("Testing sparse cross entropy", "[sparse_cross_entropy]" ) {
+    constexpr int numClasses = 4;
+    constexpr int batchSize = 3;
+    neural::Tensor<double, batchSize, numClasses> predictions, labels;
+    predictions.setValues({{0.25, 0.0, 0.25, 0.5}, {0.1, 0.6, 0.2, 0.1}, {0.7, 0.1, 0.1, 0.1}});
+    labels.setValues({{0, 0, 1, 0}, {0, 1, 0, 0}, {0, 0, 0, 1}});
+    const std::array<int, batchSize> indices = {{2, 1, 3}};
+
+    // Class indices must give the same loss, gradient and accuracy as one-hot labels
+    neural::CrossEntropy<double, numClasses, batchSize> crossEntropy;
+    neural::SparseCrossEntropy<double, numClasses, batchSize> sparseCrossEntropy;
+    REQUIRE( sparseCrossEntropy.compute(predictions, indices) == Approx(crossEntropy.compute(predictions, labels)) );
+    const auto expected = crossEntropy.gradient(predictions, labels);
+    const auto gradient = sparseCrossEntropy.gradient(predictions, indices);
+    for (int i = 0; i < batchSize * numClasses; i++) {
+        REQUIRE( gradient.data()[i] == Approx(expected.data()[i]) );
+    }
+    REQUIRE( sparseCrossEntropy.accuracy(predictions, indices) == Approx(1.0 / 3) );
+    REQUIRE( sparseCrossEntropy.accuracy(predictions, indices) == Approx(crossEntropy.accuracy(predictions, labels)) );
+
+    const std::array<int, batchSize> invalid = {{2, 4, 3}};
+    REQUIRE_THROWS( sparseCrossEntropy.compute(predictions, invalid) );
+}
+
+TEST_CASE("Testing metrics", "[metrics]" ) {
+    constexpr int numClasses = 4;
+    constexpr int batchSize = 3;
+    neural::Tensor<double, batchSize, numClasses> predictions, labels;
+    predictions.setValues({{0.25, 0.0, 0.25, 0.5}, {0.1, 0.6, 0.2, 0.1}, {0.6, 0.3, 0.1, 0.0}});
+    labels.setValues({{0, 0, 1, 0}, {0, 1, 0, 0}, {0, 0, 0, 1}});
+    const std::array<int, batchSize> indices = {{2, 1, 3}};
+
+    // Only the second sample is predicted correctly, and the label of the first is tied for the second highest score
+    neural::Metrics<numClasses, 2> metrics;
+    metrics.update(predictions, indices);
+    metrics.addLoss(1.0, batchSize);
+    REQUIRE( metrics.samples() == batchSize );
+    REQUIRE( metrics.accuracy() == Approx(1.0 / 3) );
+    REQUIRE( metrics.topKAccuracy() == Approx(2.0 / 3) );
+    REQUIRE( metrics.meanLoss() == Approx(1.0) );
+    REQUIRE( metrics.confusionMatrix()[2][3] == 1 );
+    REQUIRE( metrics.confusionMatrix()[1][1] == 1 );
+    REQUIRE( metrics.confusionMatrix()[3][0] == 1 );
+
+    // One-hot labels must give the same metrics, and merging must equal accumulating both batches in one accumulator
+    neural::Metrics<numClasses, 2> other;
+    other.update(predictions, labels);
+    other.addLoss(2.0, 1);
+    metrics.merge(other);
+    REQUIRE( metrics.samples() == 2 * batchSize );
+    REQUIRE( metrics.accuracy() == Approx(1.0 / 3) );
+    REQUIRE( metrics.topKAccuracy() == Approx(2.0 / 3) );
+    REQUIRE( metrics.meanLoss() == Approx(5.0 / 4) );
+    REQUIRE( metrics.confusionMatrix()[2][3] == 2 );
+
+    const std::array<int, batchSize> invalid = {{2, 4, 3}};
+    REQUIRE_THROWS( metrics.update(predictions, invalid) );
+    REQUIRE( metrics.samples() == 2 * batchSize );
+    metrics.reset();
+    REQUIRE( metrics.samples() == 0 );
+    REQUIRE( metrics.accuracy() == 0 );
+    REQUIRE( metrics.meanLoss() == 0 );
+}
+
 TEST_CASE("Testing net forward", "[net_forward]" ) {
     constexpr int inputSize = 10;
     constexpr int batchSize = 1;
@@ -98,9 +268,965 @@ TEST_CASE("Testing net forward", "[net_forward]" ) {
             neural::Relu<double, inputSize, batchSize>()
     );
     const auto result = net.forward(x);
+    const auto prediction = net.predict(x);
 
     for (unsigned int i = 0; i < inputSize; i++) {
         REQUIRE( expectedValues(i) == result(i) );
+        REQUIRE( expectedValues(i) == prediction(i) );
+    }
+
+    // A Net that never enables gradients doesn't carry storage for activations
+    REQUIRE( sizeof(net) < sizeof(x) );
+}
+
+TEST_CASE("Testing linear forward", "[linear_forward]" ) {
+    constexpr int inputSize = 5;
+    constexpr int numNeurons = 7;
+    constexpr int batchSize = 3;
+
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setValues({{-2, -0.5, 0.3, 1.5, 0.1}, {0.7, -1.2, 2, -0.1, 0.4}, {1, 1, -1, 0.5, -0.3}});
+
+    // Computing the whole batch at once must match computing every sample on its own (weights are seeded identically)
+    neural::Linear<double, inputSize, numNeurons, batchSize> linear;
+    neural::Linear<double, inputSize, numNeurons, 1> sampleLinear;
+    const auto result = linear.forward(x);
+    for (int i = 0; i < batchSize; i++) {
+        neural::Tensor<double, 1, inputSize> sample;
+        for (int j = 0; j < inputSize; j++) {
+            sample(0, j) = x(i, j);
+        }
+        const auto sampleResult = sampleLinear.forward(sample);
+        for (int j = 0; j < numNeurons; j++) {
+            REQUIRE( result(i, j) == Approx(sampleResult(0, j)).epsilon(1e-12) );
+        }
+    }
+
+    // Layers that never compute gradients don't carry gradient buffers
+    REQUIRE( sizeof(linear) < 2 * sizeof(linear.weights()) );
+}
+
+/**
+ * @brief Check the input gradient computed by a layer's native backward() against central finite differences of the
+ *        scalar loss sum(lossWeights * forward(input))
+ */
+template <typename Layer>
+void checkInputGradient(Layer &layer, const typename Layer::InputTensor &input, const typename Layer::OutputTensor &lossWeights) {
+    const typename Layer::OutputTensor output = layer.forward(input);
+    const typename Layer::InputTensor gradInput = layer.backward(input, output, lossWeights);
+
+    const typename Layer::OutputTensor::EigenType &lossWeightsEigen = lossWeights;
+    constexpr double h = 1e-6;
+    for (int i = 0; i < input.size(); i++) {
+        typename Layer::InputTensor inputPlus = input, inputMinus = input;
+        inputPlus.data()[i] += h;
+        inputMinus.data()[i] -= h;
+        const Eigen::Tensor<double, 0> lossPlus = (layer.forward(inputPlus) * lossWeightsEigen).sum();
+        const Eigen::Tensor<double, 0> lossMinus = (layer.forward(inputMinus) * lossWeightsEigen).sum();
+        REQUIRE( gradInput.data()[i] == Approx((lossPlus(0) - lossMinus(0)) / (2 * h)).epsilon(1e-5) );
+    }
+}
+
+TEST_CASE("Testing native layer gradients", "[native_gradients]" ) {
+    constexpr int inputSize = 4;
+    constexpr int numNeurons = 3;
+    constexpr int batchSize = 2;
+
+    neural::Tensor<double, batchSize, inputSize> x, weights;
+    x.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    weights.setValues({{0.3, -1, 0.5, 2}, {1, 0.2, -0.7, 0.4}});
+
+    neural::Relu<double, inputSize, batchSize> relu;
+    checkInputGradient(relu, x, weights);
+    neural::Sigmoid<double, inputSize, batchSize> sigmoid;
+    checkInputGradient(sigmoid, x, weights);
+    neural::Tanh<double, inputSize, batchSize> tanh;
+    checkInputGradient(tanh, x, weights);
+    neural::Softmax<double, inputSize, batchSize> softmax;
+    checkInputGradient(softmax, x, weights);
+    neural::LeakyRelu<double, inputSize, batchSize> leakyRelu;
+    checkInputGradient(leakyRelu, x, weights);
+    neural::Elu<double, inputSize, batchSize> elu;
+    checkInputGradient(elu, x, weights);
+    neural::Gelu<double, inputSize, batchSize> gelu;
+    checkInputGradient(gelu, x, weights);
+    neural::Silu<double, inputSize, batchSize> silu;
+    checkInputGradient(silu, x, weights);
+
+    neural::Tensor<double, batchSize, numNeurons> linearWeights;
+    linearWeights.setValues({{0.3, -1, 0.5}, {1, 0.2, -0.7}});
+    neural::Linear<double, inputSize, numNeurons, batchSize> linear;
+    checkInputGradient(linear, x, linearWeights);
+}
+
+TEST_CASE("Testing fused activations", "[fused_activations]" ) {
+    constexpr int inputSize = 3;
+    constexpr int numNeurons = 4;
+    constexpr int batchSize = 2;
+
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setValues({{-2, -0.5, 0.3}, {0.7, -1.2, 2}});
+    neural::Tensor<double, batchSize, numNeurons> y;
+    y.setValues({{0.1, 0.9, 0.5, 0.2}, {0.8, 0.3, 0.4, 0.6}});
+
+    // Fused layers must match a linear layer followed by the activation layer
+    auto net = neural::make_net(
+            neural::Linear<double, inputSize, numNeurons, batchSize>(),
+            neural::Relu<double, numNeurons, batchSize>(),
+            neural::Linear<double, numNeurons, numNeurons, batchSize>(),
+            neural::Tanh<double, numNeurons, batchSize>(),
+            neural::Linear<double, numNeurons, numNeurons, batchSize>(),
+            neural::Sigmoid<double, numNeurons, batchSize>()
+    );
+    auto fusedNet = neural::make_net(
+            neural::LinearRelu<double, inputSize, numNeurons, batchSize>(),
+            neural::LinearTanh<double, numNeurons, numNeurons, batchSize>(),
+            neural::LinearSigmoid<double, numNeurons, numNeurons, batchSize>()
+    );
+    net.attachOptimizer(neural::OptimizerFactory::SGD(0.5));
+    fusedNet.attachOptimizer(neural::OptimizerFactory::SGD(0.5));
+    neural::MeanSquaredError<double, numNeurons, batchSize> error;
+    for (int i = 0; i < 10; i++) {
+        net.backward(error.gradient(net.forward(x), y));
+        fusedNet.backward(error.gradient(fusedNet.forward(x), y));
+    }
+    const auto prediction = net.predict(x);
+    const auto fusedPrediction = fusedNet.predict(x);
+    for (int i = 0; i < batchSize * numNeurons; i++) {
+        REQUIRE( fusedPrediction.data()[i] == Approx(prediction.data()[i]).epsilon(1e-12) );
+    }
+
+    neural::Tensor<double, batchSize, numNeurons> lossWeights;
+    lossWeights.setValues({{0.3, -1, 0.5, 2}, {1, 0.2, -0.7, 0.4}});
+    neural::LinearSigmoid<double, inputSize, numNeurons, batchSize> linearSigmoid;
+    checkInputGradient(linearSigmoid, x, lossWeights);
+    neural::LinearTanh<double, inputSize, numNeurons, batchSize> linearTanh;
+    checkInputGradient(linearTanh, x, lossWeights);
+}
+
+TEST_CASE("Testing single sample inference", "[single_sample]" ) {
+    constexpr int inputSize = 37;
+    constexpr int hiddenSize = 20;
+    constexpr int outputSize = 9;
+
+    neural::LinearRelu<double, inputSize, hiddenSize, 1> first;
+    neural::Linear<double, hiddenSize, hiddenSize, 1> second;
+    neural::Tanh<double, hiddenSize, 1> tanh;
+    neural::Linear<double, hiddenSize, outputSize, 1, false> third;
+    neural::Sigmoid<double, outputSize, 1> sigmoid;
+    neural::Softmax<double, outputSize, 1> softmax;
+    neural::Tensor<double, 1, inputSize> x;
+    x.setRandom();
+
+    // The single sample fast paths must match the same layers computed with Eigen
+    using Matrix = Eigen::MatrixXd;
+    Matrix hidden = (neural::ConstTensorToDynamicMatrix<1, inputSize>(x) * neural::ConstTensorToDynamicMatrix<inputSize, hiddenSize>(first.weights())
+            + neural::ConstTensorToDynamicMatrix<1, hiddenSize>(first.biases())).cwiseMax(0.0);
+    hidden = (hidden * neural::ConstTensorToDynamicMatrix<hiddenSize, hiddenSize>(second.weights())
+            + neural::ConstTensorToDynamicMatrix<1, hiddenSize>(second.biases())).array().tanh().matrix();
+    Matrix expected = hidden * neural::ConstTensorToDynamicMatrix<hiddenSize, outputSize>(third.weights());
+    expected = (1.0 + (-expected.array()).exp()).inverse().exp().matrix();
+    expected /= expected.sum();
+
+    for (bool frozen : {false, true}) {
+        first.freeze(frozen);
+        second.freeze(frozen);
+        third.freeze(frozen);
+        const auto prediction = softmax.predict(sigmoid.predict(third.predict(tanh.predict(second.predict(first.predict(x))))));
+        for (int i = 0; i < outputSize; i++) {
+            REQUIRE( prediction(0, i) == Approx(expected(0, i)).epsilon(1e-12) );
+        }
+    }
+}
+
+/**
+ * @brief Get the largest absolute difference between two tensors
+ */
+template <typename Scalar, unsigned int BatchSize, unsigned int Size>
+double maxDifference(const neural::Tensor<Scalar, BatchSize, Size> &a, const neural::Tensor<Scalar, BatchSize, Size> &b) {
+    return double((neural::ConstTensorToDynamicMatrix<BatchSize, Size>(a) - neural::ConstTensorToDynamicMatrix<BatchSize, Size>(b))
+                          .cwiseAbs().maxCoeff());
+}
+
+/**
+ * @brief Check the activation layers of an accuracy policy against the exact layers
+ * @param tolerance The largest absolute error allowed
+ */
+template <typename Scalar, typename Accuracy, int BatchSize>
+void checkApproximateActivations(double tolerance) {
+    constexpr int size = 37;
+    neural::Tensor<Scalar, BatchSize, size> x;
+    x.setRandom();
+    for (int i = 0; i < BatchSize * size; i++) {
+        x.data()[i] *= 10;
+    }
+    REQUIRE( maxDifference(neural::Sigmoid<Scalar, size, BatchSize>().predict(x),
+                           neural::Sigmoid<Scalar, size, BatchSize, Accuracy>().predict(x)) < tolerance );
+    REQUIRE( maxDifference(neural::Tanh<Scalar, size, BatchSize>().predict(x),
+                           neural::Tanh<Scalar, size, BatchSize, Accuracy>().predict(x)) < tolerance );
+    REQUIRE( maxDifference(neural::Softmax<Scalar, size, BatchSize>().predict(x),
+                           neural::Softmax<Scalar, size, BatchSize, Accuracy>().predict(x)) < tolerance );
+}
+
+TEST_CASE("Testing approximate activations", "[approximate]" ) {
+    checkApproximateActivations<float, neural::accuracy::High, 1>(1e-6);
+    checkApproximateActivations<double, neural::accuracy::High, 9>(1e-6);
+    checkApproximateActivations<float, neural::accuracy::Low, 9>(1e-3);
+    checkApproximateActivations<double, neural::accuracy::Low, 1>(1e-3);
+
+    // The error of exp is relative, over the whole range of arguments
+    std::vector<double> x(2001), y(2001);
+    for (std::size_t i = 0; i < x.size(); i++) {
+        x[i] = -700 + 1400.0 * i / (x.size() - 1);
+    }
+    neural::applyExp<neural::accuracy::High>(x.data(), x.size(), y.data());
+    double maxError = 0;
+    for (std::size_t i = 0; i < x.size(); i++) {
+        maxError = std::max(maxError, std::abs(y[i] / std::exp(x[i]) - 1));
+    }
+    REQUIRE( maxError < 1e-6 );
+}
+
+/**
+ * @brief Check that an activation layer computes the same output in place as out of place
+ */
+template <typename Layer>
+void checkInPlace(const Layer &layer, const typename Layer::InputTensor &x) {
+    typename Layer::InputTensor tensor = x;
+    layer.forwardInPlace(tensor);
+    REQUIRE( maxDifference(layer.forward(x), tensor) == 0 );
+    tensor = x;
+    layer.predictInPlace(tensor);
+    REQUIRE( maxDifference(layer.predict(x), tensor) == 0 );
+}
+
+TEST_CASE("Testing in-place activations", "[in_place]" ) {
+    constexpr int inputSize = 13;
+    constexpr int hiddenSize = 20;
+    constexpr int outputSize = 9;
+    constexpr int batchSize = 7;
+
+    neural::Tensor<double, batchSize, hiddenSize> hidden;
+    hidden.setRandom();
+    checkInPlace(neural::Relu<double, hiddenSize, batchSize>(), hidden);
+    checkInPlace(neural::Sigmoid<double, hiddenSize, batchSize>(), hidden);
+    checkInPlace(neural::Tanh<double, hiddenSize, batchSize>(), hidden);
+    checkInPlace(neural::Softmax<double, hiddenSize, batchSize>(), hidden);
+    checkInPlace(neural::Softmax<double, hiddenSize, batchSize, neural::accuracy::Low>(), hidden);
+    neural::Tensor<float, 1, hiddenSize> sample;
+    sample.setRandom();
+    checkInPlace(neural::Sigmoid<float, hiddenSize, 1>(), sample);
+    checkInPlace(neural::Softmax<float, hiddenSize, 1>(), sample);
+
+    // Net only overwrites temporaries, never its input or the output of layers without an in-place variant
+    using Tanh = neural::Tanh<double, hiddenSize, batchSize>;
+    REQUIRE( (neural::detail::ForwardsInPlace<const Tanh, Tanh::InputTensor>::value) );
+    REQUIRE( (!neural::detail::ForwardsInPlace<const Tanh, const Tanh::InputTensor&>::value) );
+    REQUIRE( (!neural::detail::ForwardsInPlace<neural::Linear<double, hiddenSize, hiddenSize, batchSize>, Tanh::InputTensor>::value) );
+
+    auto net = neural::make_net(
+            neural::Relu<double, inputSize, batchSize>(),
+            neural::Linear<double, inputSize, hiddenSize, batchSize>(),
+            neural::Tanh<double, hiddenSize, batchSize>(),
+            neural::Linear<double, hiddenSize, outputSize, batchSize>(),
+            neural::Sigmoid<double, outputSize, batchSize>(),
+            neural::Softmax<double, outputSize, batchSize>()
+    );
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setRandom();
+    const neural::Tensor<double, batchSize, inputSize> input = x;
+    const auto expected = net.layer<5>().predict(net.layer<4>().predict(net.layer<3>().predict(
+            net.layer<2>().predict(net.layer<1>().predict(net.layer<0>().predict(x))))));
+    REQUIRE( maxDifference(expected, net.forward(x)) == 0 );
+    REQUIRE( maxDifference(expected, net.predict(x)) == 0 );
+    REQUIRE( maxDifference(input, x) == 0 );
+}
+
+TEST_CASE("Testing elementwise fusion", "[fusion]" ) {
+    constexpr int inputSize = 13;
+    constexpr int hiddenSize = 20;
+    constexpr int batchSize = 7;
+
+    // Runs of elementwise layers are found at compile time, and approximated activations are never fused
+    using Layers = std::tuple<neural::Tanh<float, inputSize, batchSize>, neural::Relu<float, inputSize, batchSize>,
+            neural::Linear<float, inputSize, hiddenSize, batchSize>, neural::Relu<float, hiddenSize, batchSize>,
+            neural::Tanh<float, hiddenSize, batchSize>, neural::Sigmoid<float, hiddenSize, batchSize, neural::accuracy::Low>>;
+    REQUIRE( (neural::detail::ElementwiseRun<Layers, 2>::value == 2) );
+    REQUIRE( (neural::detail::ElementwiseRun<Layers, 3>::value == 0) );
+    REQUIRE( (neural::detail::ElementwiseRun<Layers, 5>::value == 2) );
+    REQUIRE( (neural::detail::ElementwiseRun<Layers, 6>::value == 0) );
+    REQUIRE( (!neural::detail::FusesElementwise<Layers, 5, neural::Derivative>::value) );
+
+    // Fused runs at the start, middle and end of a net must match the layers applied one at a time
+    auto net = neural::make_net(
+            neural::Tanh<double, inputSize, batchSize>(),
+            neural::Relu<double, inputSize, batchSize>(),
+            neural::Linear<double, inputSize, hiddenSize, batchSize>(),
+            neural::Sigmoid<double, hiddenSize, batchSize>(),
+            neural::Tanh<double, hiddenSize, batchSize>(),
+            neural::Relu<double, hiddenSize, batchSize>(),
+            neural::Linear<double, hiddenSize, hiddenSize, batchSize>(),
+            neural::Relu<double, hiddenSize, batchSize>(),
+            neural::Sigmoid<double, hiddenSize, batchSize>()
+    );
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setRandom();
+    const neural::Tensor<double, batchSize, inputSize> input = x;
+    const auto expected = net.layer<8>().predict(net.layer<7>().predict(net.layer<6>().predict(net.layer<5>().predict(
+            net.layer<4>().predict(net.layer<3>().predict(net.layer<2>().predict(net.layer<1>().predict(net.layer<0>().predict(x)))))))));
+    REQUIRE( maxDifference(expected, net.forward(x)) < 1e-12 );
+    REQUIRE( maxDifference(expected, net.predict(x)) < 1e-12 );
+    REQUIRE( maxDifference(input, x) == 0 );
+
+    // Native training stores every activation, so it applies the layers one at a time
+    net.enableGradients();
+    REQUIRE( maxDifference(expected, net.forward(x)) < 1e-12 );
+}
+
+/**
+ * @brief Check the vectorized Elementwise layer of a functor against the scalar value of the functor
+ * @param tolerance The largest relative error allowed
+ */
+template <typename Scalar, typename Functor>
+void checkElementwise(double tolerance) {
+    constexpr int size = 37;
+    constexpr int batchSize = 9;
+    neural::Tensor<Scalar, batchSize, size> x;
+    x.setRandom();
+    for (int i = 0; i < batchSize * size; i++) {
+        x.data()[i] *= 8;
+    }
+    const auto y = neural::Elementwise<Scalar, size, batchSize, Functor>().predict(x);
+    for (int i = 0; i < batchSize * size; i++) {
+        const double expected = Functor::value(double(x.data()[i]));
+        REQUIRE( std::abs(y.data()[i] - expected) <= tolerance * std::max(1.0, std::abs(expected)) );
+    }
+}
+
+TEST_CASE("Testing elementwise layers", "[elementwise]" ) {
+    checkElementwise<float, neural::elementwise::LeakyRelu>(1e-6);
+    checkElementwise<float, neural::elementwise::Elu>(1e-6);
+    checkElementwise<float, neural::elementwise::Gelu>(1e-6);
+    checkElementwise<float, neural::elementwise::Silu>(1e-6);
+    checkElementwise<double, neural::elementwise::Elu>(1e-14);
+    checkElementwise<double, neural::elementwise::Gelu>(1e-14);
+    REQUIRE( neural::elementwise::Gelu::value(1.0) == Approx(0.8411920) );
+
+    // Elementwise layers are fused with each other and with the other activation layers
+    constexpr int inputSize = 13;
+    constexpr int batchSize = 7;
+    auto net = neural::make_net(
+            neural::Linear<double, inputSize, inputSize, batchSize>(),
+            neural::Gelu<double, inputSize, batchSize>(),
+            neural::Tanh<double, inputSize, batchSize>(),
+            neural::LeakyRelu<double, inputSize, batchSize>()
+    );
+    REQUIRE( (neural::detail::ElementwiseRun<std::tuple<neural::Linear<double, inputSize, inputSize, batchSize>,
+            neural::Gelu<double, inputSize, batchSize>, neural::Tanh<double, inputSize, batchSize>>, 3>::value == 2) );
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setRandom();
+    const auto expected = net.layer<3>().predict(net.layer<2>().predict(net.layer<1>().predict(net.layer<0>().predict(x))));
+    REQUIRE( maxDifference(expected, net.predict(x)) < 1e-12 );
+}
+
+TEST_CASE("Testing frozen weights", "[freeze]" ) {
+    constexpr int inputSize = 40;
+    constexpr int hiddenSize = 19;
+    constexpr int outputSize = 3;
+    constexpr int batchSize = 32;
+
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setRandom();
+    neural::Tensor<double, batchSize, outputSize> y;
+    y.setRandom();
+
+    auto net = neural::make_net(
+            neural::LinearTanh<double, inputSize, hiddenSize, batchSize>(),
+            neural::Linear<double, hiddenSize, outputSize, batchSize>()
+    );
+    net.attachOptimizer(neural::OptimizerFactory::SGD(0.1));
+    neural::MeanSquaredError<double, outputSize, batchSize> error;
+
+    // Predictions must not change by packing the weights
+    const auto expected = net.predict(x);
+    net.freeze();
+    const auto prediction = net.predict(x);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( prediction.data()[i] == Approx(expected.data()[i]).epsilon(1e-12) );
+    }
+
+    // Frozen weights are not updated by training
+    for (int i = 0; i < 5; i++) {
+        net.backward(error.gradient(net.forward(x), y));
+    }
+    const auto frozenPrediction = net.predict(x);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( frozenPrediction.data()[i] == expected.data()[i] );
+    }
+
+    // A net with only its first layer frozen still trains the layers after it
+    neural::LinearTanh<double, inputSize, hiddenSize, batchSize> frozenLayer;
+    frozenLayer.freeze();
+    auto partlyFrozenNet = neural::make_net(
+            std::move(frozenLayer),
+            neural::Linear<double, hiddenSize, outputSize, batchSize>()
+    );
+    partlyFrozenNet.attachOptimizer(neural::OptimizerFactory::SGD(0.1));
+    const double before = error.compute(partlyFrozenNet.predict(x), y);
+    for (int i = 0; i < 20; i++) {
+        partlyFrozenNet.backward(error.gradient(partlyFrozenNet.forward(x), y));
+    }
+    REQUIRE( error.compute(partlyFrozenNet.predict(x), y) < before );
+}
+
+/**
+ * @brief Check a frozen Linear layer storing its weights at reduced precision against the same layer at full precision
+ */
+template <typename Dtype, typename Storage>
+void checkReducedStorage(double tolerance) {
+    constexpr int inputSize = 300;
+    constexpr int outputSize = 17;
+    constexpr int batchSize = 24;
+
+    neural::Tensor<Dtype, batchSize, inputSize> x;
+    x.setRandom();
+    neural::LinearTanh<Dtype, inputSize, outputSize, batchSize> full;
+    neural::LinearTanh<Dtype, inputSize, outputSize, batchSize, true, Storage> reduced;
+    reduced.copyWeights(full);
+    const auto expected = full.predict(x);
+
+    // Weights are only stored at reduced precision once frozen
+    REQUIRE( reduced.predict(x).data()[0] == expected.data()[0] );
+    reduced.freeze();
+    const auto prediction = reduced.predict(x);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( std::abs(prediction.data()[i] - expected.data()[i]) < tolerance );
+    }
+
+    // Freezing releases the full precision weights, which are widened back from the stored weights when unfreezing
+    REQUIRE_THROWS( reduced.weights() );
+    REQUIRE_THROWS( reduced.backward(x, prediction, prediction) );
+    reduced.freeze(false);
+    const auto unfrozenPrediction = reduced.predict(x);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( std::abs(unfrozenPrediction.data()[i] - prediction.data()[i]) < 1e-5 );
+    }
+    bool rounded = true;
+    for (int i = 0; i < inputSize * outputSize; i++) {
+        rounded = rounded && reduced.weights().data()[i] == Dtype(typename Storage::template Type<Dtype>(full.weights().data()[i]));
+    }
+    REQUIRE( rounded );
+}
+
+TEST_CASE("Testing reduced precision storage", "[storage]" ) {
+    // Conversions round to nearest even, and are exact for representable values
+    REQUIRE( float(neural::bfloat16(1.5f)) == 1.5f );
+    REQUIRE( float(neural::bfloat16(1.0f + 1.0f / 256)) == 1.0f );
+    REQUIRE( float(neural::bfloat16(1.0f + 3.0f / 256)) == 1.0f + 4.0f / 256 );
+    REQUIRE( float(neural::bfloat16(-3e38f)) == Approx(-3e38f).epsilon(1e-2) );
+    REQUIRE( std::isnan(float(neural::bfloat16(std::numeric_limits<float>::quiet_NaN()))) );
+    REQUIRE( float(neural::float16(0.1f)) == Approx(0.1f).epsilon(1e-3) );
+    REQUIRE( float(neural::float16(1.0f + 1.0f / 2048)) == 1.0f );
+    REQUIRE( float(neural::float16(-65504.0f)) == -65504.0f );
+    REQUIRE( std::isinf(float(neural::float16(70000.0f))) );
+    REQUIRE( float(neural::float16(std::ldexp(3.0f, -24))) == std::ldexp(3.0f, -24) );
+    for (int i = 0; i < 1000; i++) {
+        const float value = std::ldexp(1.0f + float(std::rand()) / RAND_MAX, i % 20 - 10) * (i % 2 ? 1.0f : -1.0f);
+        REQUIRE( float(neural::bfloat16(value)) == Approx(value).epsilon(1.0 / 256) );
+        REQUIRE( float(neural::float16(value)) == Approx(value).epsilon(1.0 / 2048) );
+    }
+
+    // Products on a packed B at reduced precision match the product on the rounded B
+    using Matrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>;
+    const Matrix a = Matrix::Random(37, 130);
+    Matrix b = Matrix::Random(130, 23);
+    b = b.unaryExpr([](float value) { return float(neural::bfloat16(value)); });
+    const Matrix expected = a * b;
+    std::vector<neural::bfloat16> packed(b.size());
+    neural::packGemmRhs<37, 130, 23>(b.data(), packed.data());
+    Matrix c(37, 23);
+    neural::gemmPacked<37, 130, 23>(a.data(), packed.data(), c.data());
+    REQUIRE( (c - expected).cwiseAbs().maxCoeff() < 1e-3f );
+
+    checkReducedStorage<float, neural::storage::BFloat16>(2e-2);
+    checkReducedStorage<float, neural::storage::Float16>(2e-3);
+    checkReducedStorage<double, neural::storage::BFloat16>(2e-2);
+}
+
+/**
+ * @brief Check the int8 kernels of neural::int8Gemm against a plain int32 product for a given set of sizes
+ * @param isa The instruction set to run the kernels with
+ */
+template <unsigned int Rows, unsigned int Depth, unsigned int Columns>
+void checkInt8Gemm(neural::Isa isa = neural::cpuIsa()) {
+    constexpr unsigned int paddedDepth = neural::int8PaddedDepth(Depth);
+    std::vector<std::uint32_t> x(Rows * paddedDepth / 4);
+    for (auto &word : x) {
+        word = static_cast<std::uint32_t>(std::rand()) ^ (static_cast<std::uint32_t>(std::rand()) << 16);
+    }
+    std::vector<std::int8_t> w(Columns * paddedDepth);
+    for (auto &weight : w) {
+        weight = static_cast<std::int8_t>(std::rand() % 255 - 127);
+    }
+
+    std::vector<std::int32_t> c(Rows * Columns);
+    neural::detail::dispatch<neural::Isa::AVX512VNNI>(
+            neural::detail::Int8Gemm<Rows, paddedDepth, Columns>{x.data(), w.data(), c.data()}, isa);
+    bool equal = true;
+    for (unsigned int i = 0; i < Rows; i++) {
+        for (unsigned int j = 0; j < Columns; j++) {
+            std::int32_t expected = 0;
+            for (unsigned int k = 0; k < paddedDepth; k++) {
+                const std::uint32_t activation = (x[(k / 4) * Rows + i] >> (8 * (k % 4))) & 0xFF;
+                expected += std::int32_t(activation) * std::int32_t(w[j * paddedDepth + k]);
+            }
+            equal = equal && c[i + j * Rows] == expected;
+        }
+    }
+    REQUIRE( equal );
+}
+
+TEST_CASE("Testing quantized linear", "[quantized]" ) {
+    // Sizes covering full and partial tiles of rows and neurons, and padding of the depth
+    checkInt8Gemm<1, 5, 3>();
+    checkInt8Gemm<7, 130, 9>();
+    checkInt8Gemm<37, 784, 13>();
+
+    constexpr int inputSize = 50;
+    constexpr int numNeurons = 9;
+    constexpr int batchSize = 19;
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setRandom();
+
+    // Quantized predictions must be close to those of the layer they are converted from
+    neural::LinearRelu<double, inputSize, numNeurons, batchSize> linear;
+    const auto quantized = neural::quantize(linear);
+    const auto expected = linear.predict(x);
+    const auto prediction = quantized.predict(x);
+    const auto mappedExpected = neural::ConstTensorToDynamicMatrix<batchSize, numNeurons>(expected);
+    const auto mappedPrediction = neural::ConstTensorToDynamicMatrix<batchSize, numNeurons>(prediction);
+    REQUIRE( (mappedPrediction - mappedExpected).cwiseAbs().maxCoeff() < 0.02 * mappedExpected.cwiseAbs().maxCoeff() );
+
+    // Quantized layers can be used in a net, e.g. replacing the trained layers of another net
+    auto net = neural::make_net(
+            neural::Linear<double, inputSize, numNeurons, batchSize>(),
+            neural::Softmax<double, numNeurons, batchSize>()
+    );
+    auto quantizedNet = neural::make_net(
+            neural::quantize(net.layer<0>()),
+            neural::Softmax<double, numNeurons, batchSize>()
+    );
+    const auto netPrediction = net.predict(x);
+    const auto quantizedNetPrediction = quantizedNet.predict(x);
+    for (int i = 0; i < batchSize * numNeurons; i++) {
+        REQUIRE( quantizedNetPrediction.data()[i] == Approx(netPrediction.data()[i]).margin(0.01) );
+    }
+}
+
+/**
+ * @brief Check the matrix product kernels of one instruction set against Eigen's matrix product
+ * @param isa The instruction set to run the kernels with
+ */
+template <typename Scalar, unsigned int M, unsigned int K, unsigned int N>
+void checkDispatchedGemm(neural::Isa isa) {
+    using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    const Matrix a = Matrix::Random(M, K);
+    const Matrix b = Matrix::Random(K, N);
+    Matrix c(M, N);
+    neural::detail::dispatch<neural::Isa::AVX512>(neural::detail::MatrixProduct<M, K, N, Scalar>{a.data(), b.data(), c.data()}, isa);
+    REQUIRE( (c - a * b).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+
+    // B must be packed for the instruction set that multiplies it
+    Matrix packed(K, N);
+    neural::detail::dispatch<neural::Isa::AVX512>(neural::detail::PackRhs<M, K, N, Scalar, Scalar>{b.data(), packed.data()}, isa);
+    neural::detail::dispatch<neural::Isa::AVX512>(
+            neural::detail::MatrixProductPacked<M, K, N, Scalar, Scalar>{a.data(), packed.data(), c.data()}, isa);
+    REQUIRE( (c - a * b).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+
+    // The epilogue is applied by the kernels of every instruction set
+    const Matrix bias = Matrix::Random(1, N);
+    const Matrix expected = ((a * b).rowwise() + bias.row(0)).cwiseMax(Scalar(0));
+    neural::detail::dispatch<neural::Isa::AVX512>(neural::detail::MatrixProductPacked<M, K, N, Scalar, Scalar, neural::activation::Relu>{
+            a.data(), packed.data(), c.data(), neural::Epilogue<Scalar, neural::activation::Relu>{bias.data()}}, isa);
+    REQUIRE( (c - expected).cwiseAbs().maxCoeff() < Scalar(1e-3) );
+}
+
+TEST_CASE("Testing runtime dispatch", "[dispatch]" ) {
+    REQUIRE( neural::cpuIsa() >= neural::NativeIsa );
+
+    // Every instruction set supported by this CPU must compute the same products
+    for (int i = static_cast<int>(neural::NativeIsa); i <= static_cast<int>(neural::cpuIsa()); i++) {
+        const auto isa = static_cast<neural::Isa>(i);
+        INFO( neural::isaName(isa) );
+        checkDispatchedGemm<double, 13, 37, 11>(isa);
+        checkDispatchedGemm<double, 1, 300, 10>(isa);
+        checkDispatchedGemm<float, 70, 513, 17>(isa);
+        checkDispatchedGemm<float, 1, 64, 128>(isa);
+        checkInt8Gemm<7, 130, 9>(isa);
+    }
+}
+
+TEST_CASE("Testing sparse linear", "[sparse]" ) {
+    constexpr int inputSize = 48;
+    constexpr int numNeurons = 13;
+    constexpr int batchSize = 37;
+    neural::Tensor<float, batchSize, inputSize> x;
+    x.setRandom();
+    neural::LinearTanh<float, inputSize, numNeurons, batchSize> linear;
+    const auto mappedInput = neural::ConstTensorToDynamicMatrix<batchSize, inputSize>(x);
+
+    // Take a training step, so the biases applied by the kernels aren't zero
+    linear.attachOptimizer(neural::OptimizerFactory::SGD(0.1));
+    neural::Tensor<float, batchSize, numNeurons> gradOutput;
+    gradOutput.setRandom();
+    linear.backward(x, linear.forward(x), gradOutput);
+    linear.updateWeights();
+    REQUIRE( linear.biases()(0, 0) != 0.0f );
+
+    // Without pruning, predictions match those of the dense layer
+    const auto dense = neural::prune(linear, 0.0);
+    REQUIRE( dense.density() == 1.0 );
+    const auto expected = linear.predict(x);
+    const auto densePrediction = dense.predict(x);
+    for (int i = 0; i < batchSize * numNeurons; i++) {
+        REQUIRE( densePrediction.data()[i] == Approx(expected.data()[i]).margin(1e-5) );
+    }
+
+    // Pruning keeps the blocks with the largest norms, and predicts using only those
+    const auto sparse = neural::prune<4, 4>(linear, 0.8);
+    REQUIRE( sparse.density() == Approx(0.2).margin(0.01) );
+    const auto pruned = sparse.weights();
+    const auto original = linear.weights();
+    float minKept = 1e30f, maxPruned = 0.0f;
+    for (int p = 0; p < inputSize / 4; p++) {
+        for (int g = 0; g < (numNeurons + 3) / 4; g++) {
+            float norm = 0.0f;
+            bool kept = false;
+            for (int k = 4 * p; k < 4 * p + 4; k++) {
+                for (int j = 4 * g; j < std::min(4 * g + 4, numNeurons); j++) {
+                    norm += original(k, j) * original(k, j);
+                    kept = kept || pruned(k, j) != 0.0f;
+                }
+            }
+            if (kept) {
+                minKept = std::min(minKept, norm);
+            } else {
+                maxPruned = std::max(maxPruned, norm);
+            }
+        }
+    }
+    REQUIRE( maxPruned <= minKept );
+
+    const auto mappedPruned = neural::ConstTensorToDynamicMatrix<inputSize, numNeurons>(pruned);
+    const auto mappedBiases = neural::ConstTensorToDynamicMatrix<1, numNeurons>(linear.biases());
+    const Eigen::MatrixXf sparseExpected = ((mappedInput * mappedPruned).rowwise() + mappedBiases.row(0)).array().tanh();
+    const auto sparsePrediction = sparse.predict(x);
+    const auto mappedPrediction = neural::ConstTensorToDynamicMatrix<batchSize, numNeurons>(sparsePrediction);
+    REQUIRE( (mappedPrediction - sparseExpected).cwiseAbs().maxCoeff() < 1e-5f );
+
+    // Sparse layers can be used in a net
+    auto sparseNet = neural::make_net(
+            neural::prune(linear, 0.5),
+            neural::Softmax<float, numNeurons, batchSize>()
+    );
+    const auto netPrediction = sparseNet.predict(x);
+    for (int i = 0; i < batchSize; i++) {
+        REQUIRE( netPrediction.data()[i] > 0.0f );
+    }
+    REQUIRE_THROWS( neural::prune(linear, 1.5) );
+}
+
+TEST_CASE("Testing low rank linear", "[low_rank]" ) {
+    constexpr int inputSize = 60;
+    constexpr int numNeurons = 25;
+    constexpr int batchSize = 21;
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setRandom();
+    neural::LinearSigmoid<double, inputSize, numNeurons, batchSize> linear;
+
+    // Take a training step, so the biases applied by the kernels aren't zero
+    linear.attachOptimizer(neural::OptimizerFactory::SGD(0.1));
+    neural::Tensor<double, batchSize, numNeurons> gradOutput;
+    gradOutput.setRandom();
+    linear.backward(x, linear.forward(x), gradOutput);
+    linear.updateWeights();
+    REQUIRE( linear.biases()(0, 0) != 0.0 );
+
+    // At full rank, the factorization is exact
+    const auto full = neural::factorize<numNeurons>(linear);
+    const auto expected = linear.predict(x);
+    const auto fullPrediction = full.predict(x);
+    for (int i = 0; i < batchSize * numNeurons; i++) {
+        REQUIRE( fullPrediction.data()[i] == Approx(expected.data()[i]).margin(1e-10) );
+    }
+
+    // At lower rank, the weights are the best approximation of that rank, and predictions use those weights
+    constexpr int rank = 8;
+    const auto lowRank = neural::factorize<rank>(linear);
+    REQUIRE( lowRank.weightsBytes() == (inputSize + numNeurons) * rank * sizeof(double) );
+    const auto mappedWeights = neural::ConstTensorToDynamicMatrix<inputSize, numNeurons>(linear.weights());
+    const Eigen::JacobiSVD<Eigen::MatrixXd> svd(mappedWeights, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    const Eigen::MatrixXd best = svd.matrixU().leftCols(rank) * svd.singularValues().head(rank).asDiagonal() *
+                                 svd.matrixV().leftCols(rank).transpose();
+    const auto approximated = lowRank.weights();
+    const auto mappedApproximated = neural::ConstTensorToDynamicMatrix<inputSize, numNeurons>(approximated);
+    REQUIRE( (mappedApproximated - best).cwiseAbs().maxCoeff() < 1e-10 );
+
+    const auto mappedInput = neural::ConstTensorToDynamicMatrix<batchSize, inputSize>(x);
+    const auto mappedBiases = neural::ConstTensorToDynamicMatrix<1, numNeurons>(linear.biases());
+    const Eigen::MatrixXd lowRankExpected =
+            (1.0 + (-((mappedInput * best).rowwise() + mappedBiases.row(0)).array()).exp()).inverse().matrix();
+    const auto lowRankPrediction = lowRank.predict(x);
+    const auto mappedPrediction = neural::ConstTensorToDynamicMatrix<batchSize, numNeurons>(lowRankPrediction);
+    REQUIRE( (mappedPrediction - lowRankExpected).cwiseAbs().maxCoeff() < 1e-10 );
+
+    // Low rank layers can be used in a net
+    auto lowRankNet = neural::make_net(
+            neural::factorize<rank>(linear),
+            neural::Softmax<double, numNeurons, batchSize>()
+    );
+    const auto netPrediction = lowRankNet.predict(x);
+    const auto mappedNetPrediction = neural::ConstTensorToDynamicMatrix<batchSize, numNeurons>(netPrediction);
+    REQUIRE( (mappedNetPrediction.rowwise().sum().array() - 1.0).abs().maxCoeff() < 1e-10 );
+}
+
+TEST_CASE("Testing native XOR", "[native_xor]" ) {
+    constexpr int inputSize = 2;
+    constexpr int batchSize = 4;
+    constexpr int outputSize = 1;
+
+    // XOR dataset, trained as a single batch
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setValues({{0, 0}, {0, 1}, {1, 0}, {1, 1}});
+    neural::Tensor<double, batchSize, outputSize> y;
+    y.setValues({{0}, {1}, {1}, {0}});
+
+    // Create network
+    auto net = neural::make_net(
+            neural::Linear<double, inputSize, 8, batchSize>(),
+            neural::Tanh<double, 8, batchSize>(),
+            neural::Linear<double, 8, outputSize, batchSize>(),
+            neural::Sigmoid<double, outputSize, batchSize>()
+    );
+    net.attachOptimizer(neural::OptimizerFactory::Adam(0.05));
+
+    // Create loss function
+    neural::MeanSquaredError<double, outputSize, batchSize> error;
+
+    // Train
+    for (int i = 0; i < 1000; i++) {
+        const auto prediction = net.forward(x);
+        net.backward(error.gradient(prediction, y));
+    }
+
+    // Test network
+    const auto prediction = net.forward(x);
+    REQUIRE( error.compute(prediction, y) < 0.01 );
+    for (int i = 0; i < batchSize; i++) {
+        REQUIRE( std::round(prediction(i)) == y(i) );
+    }
+}
+
+TEST_CASE("Testing gradient accumulation", "[accumulation]" ) {
+    constexpr int inputSize = 2;
+    constexpr int outputSize = 2;
+
+    // A full batch, and the same batch split into two micro-batches
+    neural::Tensor<double, 4, inputSize> x;
+    x.setValues({{0, 0.5}, {-1, 1}, {1, 0.2}, {0.3, -0.4}});
+    neural::Tensor<double, 4, outputSize> y;
+    y.setValues({{0.1, 0.9}, {0.8, 0.3}, {0.4, 0.6}, {0.7, 0.2}});
+    neural::Tensor<double, 2, inputSize> x0, x1;
+    x0.setValues({{0, 0.5}, {-1, 1}});
+    x1.setValues({{1, 0.2}, {0.3, -0.4}});
+    neural::Tensor<double, 2, outputSize> y0, y1;
+    y0.setValues({{0.1, 0.9}, {0.8, 0.3}});
+    y1.setValues({{0.4, 0.6}, {0.7, 0.2}});
+
+    auto fullNet = neural::make_net(
+            neural::Linear<double, inputSize, 8, 4>(),
+            neural::Tanh<double, 8, 4>(),
+            neural::Linear<double, 8, outputSize, 4>(),
+            neural::Sigmoid<double, outputSize, 4>()
+    );
+    auto microNet = neural::make_net(
+            neural::Linear<double, inputSize, 8, 2>(),
+            neural::Tanh<double, 8, 2>(),
+            neural::Linear<double, 8, outputSize, 2>(),
+            neural::Sigmoid<double, outputSize, 2>()
+    );
+    fullNet.attachOptimizer(neural::OptimizerFactory::SGD(0.5));
+    microNet.attachOptimizer(neural::OptimizerFactory::SGD(0.5));
+    microNet.setGradientAccumulation(2);
+    neural::MeanSquaredError<double, outputSize, 4> fullError;
+    neural::MeanSquaredError<double, outputSize, 2> microError;
+
+    for (int i = 0; i < 5; i++) {
+        fullNet.backward(fullError.gradient(fullNet.forward(x), y));
+
+        // No update may happen until both micro-batches have been accumulated
+        const auto before = microNet.predict(x0);
+        microNet.backward(microError.gradient(microNet.forward(x0), y0));
+        const auto after = microNet.predict(x0);
+        for (int j = 0; j < before.size(); j++) {
+            REQUIRE( after.data()[j] == before.data()[j] );
+        }
+        microNet.backward(microError.gradient(microNet.forward(x1), y1));
+    }
+
+    const auto fullPrediction = fullNet.predict(x);
+    const auto microPrediction0 = microNet.predict(x0);
+    const auto microPrediction1 = microNet.predict(x1);
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < outputSize; j++) {
+            REQUIRE( microPrediction0(i, j) == Approx(fullPrediction(i, j)).epsilon(1e-12) );
+            REQUIRE( microPrediction1(i, j) == Approx(fullPrediction(i + 2, j)).epsilon(1e-12) );
+        }
+    }
+
+    // Remaining gradients can be applied explicitly
+    microNet.backward(microError.gradient(microNet.forward(x0), y0));
+    microNet.applyGradients();
+    REQUIRE( microNet.predict(x0)(0, 0) != Approx(microPrediction0(0, 0)).epsilon(1e-12) );
+    REQUIRE_THROWS( microNet.setGradientAccumulation(0) );
+}
+
+TEST_CASE("Testing activation checkpointing", "[checkpoint]" ) {
+    constexpr int inputSize = 2;
+    constexpr int batchSize = 4;
+    constexpr int outputSize = 2;
+
+    neural::Tensor<double, batchSize, inputSize> x;
+    x.setValues({{0, 0.5}, {-1, 1}, {1, 0.2}, {0.3, -0.4}});
+    neural::Tensor<double, batchSize, outputSize> y;
+    y.setValues({{0.1, 0.9}, {0.8, 0.3}, {0.4, 0.6}, {0.7, 0.2}});
+
+    auto net = neural::make_net(
+            neural::Linear<double, inputSize, 16, batchSize>(),
+            neural::Tanh<double, 16, batchSize>(),
+            neural::Linear<double, 16, 16, batchSize>(),
+            neural::Relu<double, 16, batchSize>(),
+            neural::Linear<double, 16, outputSize, batchSize>(),
+            neural::Sigmoid<double, outputSize, batchSize>()
+    );
+    auto checkpointNet = neural::make_net(
+            neural::make_checkpoint(
+                    neural::Linear<double, inputSize, 16, batchSize>(),
+                    neural::Tanh<double, 16, batchSize>(),
+                    neural::Linear<double, 16, 16, batchSize>(),
+                    neural::Relu<double, 16, batchSize>()
+            ),
+            neural::make_checkpoint(
+                    neural::Linear<double, 16, outputSize, batchSize>(),
+                    neural::Sigmoid<double, outputSize, batchSize>()
+            )
+    );
+
+    // Only the inputs and outputs of the segments are stored
+    REQUIRE( sizeof(decltype(checkpointNet)::Activations) < sizeof(decltype(net)::Activations) );
+
+    net.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    checkpointNet.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    neural::MeanSquaredError<double, outputSize, batchSize> error;
+    for (int i = 0; i < 10; i++) {
+        net.backward(error.gradient(net.forward(x), y));
+        checkpointNet.backward(error.gradient(checkpointNet.forward(x), y));
+    }
+
+    // Recomputing activations yields the exact same training
+    const auto prediction = net.predict(x);
+    const auto checkpointPrediction = checkpointNet.predict(x);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( checkpointPrediction.data()[i] == Approx(prediction.data()[i]).epsilon(1e-12) );
+    }
+}
+
+TEST_CASE("Testing data parallel training", "[data_parallel]" ) {
+    constexpr int inputSize = 2;
+    constexpr int outputSize = 2;
+
+    // A full batch, and the same batch split between two replicas
+    neural::Tensor<double, 4, inputSize> x;
+    x.setValues({{0, 0.5}, {-1, 1}, {1, 0.2}, {0.3, -0.4}});
+    neural::Tensor<double, 4, outputSize> y;
+    y.setValues({{0.1, 0.9}, {0.8, 0.3}, {0.4, 0.6}, {0.7, 0.2}});
+    std::array<neural::Tensor<double, 2, inputSize>, 2> xs;
+    xs[0].setValues({{0, 0.5}, {-1, 1}});
+    xs[1].setValues({{1, 0.2}, {0.3, -0.4}});
+    std::array<neural::Tensor<double, 2, outputSize>, 2> ys;
+    ys[0].setValues({{0.1, 0.9}, {0.8, 0.3}});
+    ys[1].setValues({{0.4, 0.6}, {0.7, 0.2}});
+
+    auto fullNet = neural::make_net(
+            neural::Linear<double, inputSize, 8, 4>(),
+            neural::Tanh<double, 8, 4>(),
+            neural::Linear<double, 8, outputSize, 4>(),
+            neural::Sigmoid<double, outputSize, 4>()
+    );
+    auto net = neural::make_net(
+            neural::Linear<double, inputSize, 8, 2>(),
+            neural::Tanh<double, 8, 2>(),
+            neural::Linear<double, 8, outputSize, 2>(),
+            neural::Sigmoid<double, outputSize, 2>()
+    );
+    fullNet.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    net.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    neural::MeanSquaredError<double, outputSize, 4> fullError;
+    neural::MeanSquaredError<double, outputSize, 2> error;
+
+    neural::DataParallel<decltype(net), 2> trainer(net);
+    for (int i = 0; i < 10; i++) {
+        fullNet.backward(fullError.gradient(fullNet.forward(x), y));
+        trainer.step([&](decltype(net) &replica, unsigned int index) {
+            replica.computeGradients(error.gradient(replica.forward(xs[index]), ys[index]));
+        });
+    }
+
+    // Training on replicas is equivalent to training on the full batch
+    const auto fullPrediction = fullNet.predict(x);
+    for (int r = 0; r < 2; r++) {
+        const auto prediction = net.predict(xs[r]);
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < outputSize; j++) {
+                REQUIRE( prediction(i, j) == Approx(fullPrediction(i + 2 * r, j)).epsilon(1e-12) );
+            }
+        }
+    }
+
+    // Errors on replica threads are rethrown on the calling thread, and the gradients of the other replicas discarded
+    REQUIRE_THROWS( trainer.step([&](decltype(net) &replica, unsigned int index) {
+        if (index == 1) {
+            throw std::runtime_error("Replica failed");
+        }
+        replica.computeGradients(error.gradient(replica.forward(xs[index]), ys[index]));
+    }) );
+    REQUIRE( net.accumulatedSteps() == 0 );
+
+    // Every replica step counts towards gradient accumulation, so four replica steps make up two full batch steps
+    fullNet.setGradientAccumulation(2);
+    net.setGradientAccumulation(4);
+    const auto trainStep = [&](decltype(net) &replica, unsigned int index) {
+        replica.computeGradients(error.gradient(replica.forward(xs[index]), ys[index]));
+    };
+    const auto before = net.predict(xs[0]);
+    trainer.step(trainStep);
+    const auto accumulating = net.predict(xs[0]);
+    for (int i = 0; i < 2 * outputSize; i++) {
+        REQUIRE( accumulating.data()[i] == before.data()[i] );
+    }
+    fullNet.backward(fullError.gradient(fullNet.forward(x), y));
+    fullNet.backward(fullError.gradient(fullNet.forward(x), y));
+    trainer.step(trainStep);
+
+    // Training continues as if the failed step never happened
+    const auto accumulatedPrediction = fullNet.predict(x);
+    for (int r = 0; r < 2; r++) {
+        const auto prediction = net.predict(xs[r]);
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < outputSize; j++) {
+                REQUIRE( prediction(i, j) == Approx(accumulatedPrediction(i + 2 * r, j)).epsilon(1e-12) );
+            }
+        }
     }
 }
 
@@ -158,6 +1284,284 @@ TEST_CASE("Testing ReLu", "[relu]" ) {
     }
 }
 
+TEST_CASE("Testing elementwise auto diff", "[elementwise_autodiff]" ) {
+    neural::GradientGuard guard;
+    constexpr int inputSize = 4;
+    constexpr int batchSize = 2;
+
+    neural::Tensor<double, batchSize, inputSize> values, weights;
+    values.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    weights.setValues({{0.3, -1, 0.5, 2}, {1, 0.2, -0.7, 0.4}});
+    const neural::Tensor<neural::Derivative, batchSize, inputSize> x = values.cast<neural::Derivative>();
+
+    // Auto diff through the scalar values of the functor must match the derivative of the native backward pass
+    neural::Gelu<neural::Derivative, inputSize, batchSize> gelu;
+    neural::Gelu<double, inputSize, batchSize> nativeGelu;
+    const auto y = gelu.forward(x);
+    neural::Derivative loss = 0;
+    for (int i = 0; i < batchSize * inputSize; i++) {
+        loss += y.data()[i] * weights.data()[i];
+    }
+    loss.grad();
+    const auto expected = nativeGelu.backward(values, nativeGelu.forward(values), weights);
+    for (int i = 0; i < batchSize * inputSize; i++) {
+        REQUIRE( x.data()[i].adj() == Approx(expected.data()[i]) );
+    }
+}
+
+TEST_CASE("Testing Linear auto diff", "[linear_autodiff]" ) {
+    neural::GradientGuard guard;
+    constexpr int inputSize = 4;
+    constexpr int numNeurons = 3;
+    constexpr int batchSize = 2;
+
+    neural::Tensor<neural::Derivative, batchSize, inputSize> x;
+    x.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    neural::Tensor<double, batchSize, numNeurons> weights;
+    weights.setValues({{0.3, -1, 0.5}, {1, 0.2, -0.7}});
+    neural::Linear<neural::Derivative, inputSize, numNeurons, batchSize> linear;
+
+    // The whole layer is recorded as a single node with non-chained outputs
+    const auto stackSize = stan::math::ChainableStack::var_stack_.size();
+    const auto output = linear.forward(x);
+    REQUIRE( stan::math::ChainableStack::var_stack_.size() == stackSize + 1 );
+
+    // Evaluate gradient of sum(weights * output)
+    neural::Derivative loss = 0;
+    for (int i = 0; i < output.size(); i++) {
+        loss += weights.data()[i] * output.data()[i];
+    }
+    loss.grad();
+
+    // Compare against central finite differences
+    constexpr double h = 1e-6;
+    for (int i = 0; i < x.size(); i++) {
+        neural::Tensor<neural::Derivative, batchSize, inputSize> xPlus = x, xMinus = x;
+        xPlus.data()[i] += h;
+        xMinus.data()[i] -= h;
+        const auto outputPlus = linear.forward(xPlus);
+        const auto outputMinus = linear.forward(xMinus);
+        double difference = 0;
+        for (int j = 0; j < output.size(); j++) {
+            difference += weights.data()[j] * (outputPlus.data()[j].val() - outputMinus.data()[j].val());
+        }
+        REQUIRE( x.data()[i].adj() == Approx(difference / (2 * h)).epsilon(1e-5) );
+    }
+}
+
+TEST_CASE("Testing softmax cross entropy auto diff", "[softmax_cross_entropy_autodiff]" ) {
+    neural::GradientGuard guard;
+    constexpr int numClasses = 3;
+    constexpr int batchSize = 2;
+
+    neural::Tensor<double, batchSize, numClasses> logitValues, labelValues;
+    logitValues.setValues({{-2, -0.5, 0.3}, {0.7, 2, -0.1}});
+    labelValues.setValues({{0, 0, 1}, {1, 0, 0}});
+    const neural::Tensor<neural::Derivative, batchSize, numClasses> logits = logitValues.cast<neural::Derivative>();
+    const neural::Tensor<neural::Derivative, batchSize, numClasses> labels = labelValues.cast<neural::Derivative>();
+
+    // The whole loss is recorded as a single node, which propagates the closed-form gradient to the logits
+    neural::SoftmaxCrossEntropy<neural::Derivative, numClasses, batchSize> error;
+    neural::SoftmaxCrossEntropy<double, numClasses, batchSize> nativeError;
+    const auto stackSize = stan::math::ChainableStack::var_stack_.size();
+    auto loss = error.compute(logits, labels);
+    REQUIRE( stan::math::ChainableStack::var_stack_.size() == stackSize + 1 );
+    REQUIRE( loss.val() == Approx(nativeError.compute(logitValues, labelValues)) );
+
+    loss.grad();
+    const auto expected = nativeError.gradient(logitValues, labelValues);
+    for (int i = 0; i < batchSize * numClasses; i++) {
+        REQUIRE( logits.data()[i].adj() == Approx(expected.data()[i]) );
+    }
+}
+
+TEST_CASE("Testing sparse cross entropy auto diff", "[sparse_cross_entropy_autodiff]" ) {
+    neural::GradientGuard guard;
+    constexpr int numClasses = 3;
+    constexpr int batchSize = 2;
+
+    neural::Tensor<neural::Derivative, batchSize, numClasses> predictions;
+    predictions.setValues({{0.2, 0.3, 0.5}, {0.6, 0.3, 0.1}});
+    neural::Tensor<double, batchSize, numClasses> values;
+    values.setValues({{0.2, 0.3, 0.5}, {0.6, 0.3, 0.1}});
+    const std::array<int, batchSize> indices = {{1, 0}};
+
+    // Gradients only reach the predicted probabilities of the labelled classes
+    neural::SparseCrossEntropy<neural::Derivative, numClasses, batchSize> error;
+    neural::SparseCrossEntropy<double, numClasses, batchSize> nativeError;
+    auto loss = error.compute(predictions, indices);
+    REQUIRE( loss.val() == Approx(nativeError.compute(values, indices)) );
+    loss.grad();
+    const auto expected = nativeError.gradient(values, indices);
+    for (int i = 0; i < batchSize * numClasses; i++) {
+        REQUIRE( predictions.data()[i].adj() == Approx(expected.data()[i]) );
+    }
+}
+
+TEST_CASE("Testing predict", "[predict]" ) {
+    neural::GradientGuard guard;
+    constexpr int inputSize = 4;
+    constexpr int batchSize = 2;
+    constexpr int outputSize = 3;
+
+    neural::Tensor<neural::Derivative, batchSize, inputSize> x;
+    x.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    neural::Tensor<double, batchSize, inputSize> xValues;
+    xValues.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+
+    auto net = neural::make_net(
+            neural::Linear<neural::Derivative, inputSize, 8, batchSize>(),
+            neural::Relu<neural::Derivative, 8, batchSize>(),
+            neural::Linear<neural::Derivative, 8, 8, batchSize>(),
+            neural::Sigmoid<neural::Derivative, 8, batchSize>(),
+            neural::Linear<neural::Derivative, 8, outputSize, batchSize>(),
+            neural::Tanh<neural::Derivative, outputSize, batchSize>(),
+            neural::Softmax<neural::Derivative, outputSize, batchSize>()
+    );
+    const auto result = net.forward(x);
+
+    // Predicting on plain values gives the same result without recording anything on the tape
+    const auto stackSize = stan::math::ChainableStack::var_stack_.size();
+    const neural::Tensor<double, batchSize, outputSize> prediction = net.predict(xValues);
+    REQUIRE( stan::math::ChainableStack::var_stack_.size() == stackSize );
+    for (int i = 0; i < result.size(); i++) {
+        REQUIRE( prediction.data()[i] == Approx(result.data()[i].val()) );
+    }
+}
+
+TEST_CASE("Testing gradient arena", "[arena]" ) {
+    constexpr int inputSize = 4;
+    constexpr int batchSize = 2;
+    constexpr int outputSize = 3;
+
+    neural::Tensor<double, batchSize, inputSize> xValues;
+    xValues.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    neural::Tensor<double, batchSize, outputSize> yValues;
+    yValues.setValues({{0, 1, 0}, {1, 0, 0}});
+
+    auto net = neural::make_net(
+            neural::Linear<neural::Derivative, inputSize, 8, batchSize>(),
+            neural::Tanh<neural::Derivative, 8, batchSize>(),
+            neural::Linear<neural::Derivative, 8, outputSize, batchSize>(),
+            neural::Softmax<neural::Derivative, outputSize, batchSize>()
+    );
+    net.attachOptimizer(neural::OptimizerFactory::SGD(0.1));
+    neural::CrossEntropy<neural::Derivative, outputSize, batchSize> error;
+
+    const auto stackSize = stan::math::ChainableStack::var_stack_.size();
+    for (int i = 0; i < 20; i++) {
+        neural::GradientGuard guard(net.arena());
+        const neural::Tensor<neural::Derivative, batchSize, inputSize> x = xValues.cast<neural::Derivative>();
+        const neural::Tensor<neural::Derivative, batchSize, outputSize> y = yValues.cast<neural::Derivative>();
+        auto loss = error.compute(net.forward(x), y);
+        net.backward(loss);
+    }
+
+    // The arena only grows while the first steps are recorded, and everything recorded is released again
+    REQUIRE( net.arena().numGrowths() >= 1 );
+    REQUIRE( net.arena().nodesUsed() > 0 );
+    REQUIRE( net.arena().bytesUsed() <= net.arena().peakBytes() );
+    const auto numGrowths = net.arena().numGrowths();
+    for (int i = 0; i < 20; i++) {
+        neural::GradientGuard guard(net.arena());
+        const neural::Tensor<neural::Derivative, batchSize, inputSize> x = xValues.cast<neural::Derivative>();
+        const neural::Tensor<neural::Derivative, batchSize, outputSize> y = yValues.cast<neural::Derivative>();
+        auto loss = error.compute(net.forward(x), y);
+        net.backward(loss);
+    }
+    REQUIRE( net.arena().numGrowths() == numGrowths );
+    REQUIRE( stan::math::ChainableStack::var_stack_.size() == stackSize );
+}
+
+TEST_CASE("Testing auto diff and native equivalence", "[equivalence]" ) {
+    constexpr int inputSize = 4;
+    constexpr int batchSize = 2;
+    constexpr int outputSize = 3;
+
+    neural::Tensor<double, batchSize, inputSize> xValues;
+    xValues.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    neural::Tensor<double, batchSize, outputSize> yValues;
+    yValues.setValues({{0.2, 0.9, 0.1}, {0.8, 0.3, 0.5}});
+
+    // Both nets start out with identical weights, as the initializers are seeded identically
+    auto autoDiffNet = neural::make_net(
+            neural::Linear<neural::Derivative, inputSize, 8, batchSize>(),
+            neural::Tanh<neural::Derivative, 8, batchSize>(),
+            neural::Linear<neural::Derivative, 8, outputSize, batchSize>(),
+            neural::Sigmoid<neural::Derivative, outputSize, batchSize>()
+    );
+    auto nativeNet = neural::make_net(
+            neural::Linear<double, inputSize, 8, batchSize>(),
+            neural::Tanh<double, 8, batchSize>(),
+            neural::Linear<double, 8, outputSize, batchSize>(),
+            neural::Sigmoid<double, outputSize, batchSize>()
+    );
+    autoDiffNet.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    nativeNet.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    neural::MeanSquaredError<neural::Derivative, outputSize, batchSize> autoDiffError;
+    neural::MeanSquaredError<double, outputSize, batchSize> nativeError;
+
+    // Weights live outside the tape, so they must stay valid across the nested scopes of repeated steps
+    for (int i = 0; i < 10; i++) {
+        neural::GradientGuard guard(autoDiffNet.arena());
+        const neural::Tensor<neural::Derivative, batchSize, inputSize> x = xValues.cast<neural::Derivative>();
+        const neural::Tensor<neural::Derivative, batchSize, outputSize> y = yValues.cast<neural::Derivative>();
+        auto loss = autoDiffError.compute(autoDiffNet.forward(x), y);
+        autoDiffNet.backward(loss);
+
+        nativeNet.backward(nativeError.gradient(nativeNet.forward(xValues), yValues));
+    }
+
+    const auto autoDiffPrediction = autoDiffNet.predict(xValues);
+    const auto nativePrediction = nativeNet.predict(xValues);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( autoDiffPrediction.data()[i] == Approx(nativePrediction.data()[i]).epsilon(1e-9) );
+    }
+}
+
+TEST_CASE("Testing fused auto diff", "[fused_autodiff]" ) {
+    constexpr int inputSize = 4;
+    constexpr int batchSize = 2;
+    constexpr int outputSize = 3;
+
+    neural::Tensor<double, batchSize, inputSize> xValues;
+    xValues.setValues({{-2, -0.5, 0.3, 1.5}, {0.7, -1.2, 2, -0.1}});
+    neural::Tensor<double, batchSize, outputSize> yValues;
+    yValues.setValues({{0.2, 0.9, 0.1}, {0.8, 0.3, 0.5}});
+
+    // The fused activations are propagated by the single node recording each layer
+    auto autoDiffNet = neural::make_net(
+            neural::LinearTanh<neural::Derivative, inputSize, 8, batchSize>(),
+            neural::LinearSigmoid<neural::Derivative, 8, outputSize, batchSize>()
+    );
+    auto nativeNet = neural::make_net(
+            neural::Linear<double, inputSize, 8, batchSize>(),
+            neural::Tanh<double, 8, batchSize>(),
+            neural::Linear<double, 8, outputSize, batchSize>(),
+            neural::Sigmoid<double, outputSize, batchSize>()
+    );
+    autoDiffNet.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    nativeNet.attachOptimizer(neural::OptimizerFactory::Adam(0.01));
+    neural::MeanSquaredError<neural::Derivative, outputSize, batchSize> autoDiffError;
+    neural::MeanSquaredError<double, outputSize, batchSize> nativeError;
+
+    for (int i = 0; i < 10; i++) {
+        neural::GradientGuard guard(autoDiffNet.arena());
+        const neural::Tensor<neural::Derivative, batchSize, inputSize> x = xValues.cast<neural::Derivative>();
+        const neural::Tensor<neural::Derivative, batchSize, outputSize> y = yValues.cast<neural::Derivative>();
+        auto loss = autoDiffError.compute(autoDiffNet.forward(x), y);
+        autoDiffNet.backward(loss);
+
+        nativeNet.backward(nativeError.gradient(nativeNet.forward(xValues), yValues));
+    }
+
+    const auto autoDiffPrediction = autoDiffNet.predict(xValues);
+    const auto nativePrediction = nativeNet.predict(xValues);
+    for (int i = 0; i < batchSize * outputSize; i++) {
+        REQUIRE( autoDiffPrediction.data()[i] == Approx(nativePrediction.data()[i]).epsilon(1e-9) );
+    }
+}
+
 TEST_CASE("Testing backprop", "[backprop]" ) {
     constexpr int inputSize = 10;
     constexpr int numNeurons = 5;